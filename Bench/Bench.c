@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "../Include/Engine.h"
+#include "../Include/Generator.h"
+
+#define DEFAULT_RUNS 3
+#define DEFAULT_THRESHOLD 10.0
+#define NB_PRIORITY 8
+#define CPU_USAGE_LIMIT 3
+#define MAX_EXEC_TIME 256
+#define MAX_CASES 256
+
+static const char* const algorithms[] = { "Fifo", "RoundRobin", "PreemptivePriority", "Multilevel" };
+static const int densities[] = { 0, 4 };
+static const int quanta[] = { 2, 8 };
+
+typedef struct bench_result{
+    char name[96];
+    const char* algorithm;
+    int processes;
+    int events;
+    int quantum;
+    int runs;
+    long long slices;
+    long long decisions;
+    long long allocations;
+    double seconds;
+    long peak_rss_kb;
+} bench_result;
+
+// Counted through -Wl,--wrap, see the Makefile.
+static long long allocations;
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size){
+    allocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size){
+    allocations++;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size){
+    allocations++;
+    return __real_realloc(ptr, size);
+}
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Arrivals about as frequent as completions, so queues stay busy without
+// growing unbounded.
+static process* generate(int n, int events, uint64_t seed){
+    gen_params params;
+    gen_defaults(&params);
+    params.seed = seed;
+    params.nb_processes = n;
+    params.rate = 1.0 / 12;
+    params.exec_mean = 12;
+    params.max_exec = MAX_EXEC_TIME;
+    params.min_priority = 0;
+    params.max_priority = NB_PRIORITY - 1;
+    params.events_mean = events;
+    return gen_workload(&params);
+}
+
+static int count_slice(void* ctx, const execute* e){
+    (void)e;
+    (*(long long*)ctx)++;
+    return 0;
+}
+
+static int compare_double(const void* a, const void* b){
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// The engine alone: slices go to a counting sink, every sim_step is one
+// scheduling decision. Reports the median of the runs. A run sorts and
+// consumes its processes' events, so each one gets a freshly generated
+// workload, made before the clock starts.
+static int run_case(bench_result* r, int nb_cpus){
+    double* times = (double*)malloc(r->runs * sizeof(double));
+    const policy* pol = find_policy(r->algorithm);
+    if (times == NULL || pol == NULL) return -1;
+
+    sim_params params = { r->quantum, NB_PRIORITY, CPU_USAGE_LIMIT, nb_cpus };
+    for (int i = 0; i < r->runs; i++){
+        process* workload = generate(r->processes, r->events, 42);
+        if (workload == NULL) return -1;
+        long long slices = 0, decisions = 0;
+        slice_sink sink = { count_slice, &slices };
+        long long before = allocations;
+
+        double start = now();
+        sim* s = sim_create(pol, workload, r->processes, &params);
+        if (s == NULL) return -1;
+        sim_start(s, &sink);
+        int status;
+        while ((status = sim_step(s)) > 0)
+            decisions++;
+        sim_free(s);
+        times[i] = now() - start;
+        free(workload);
+
+        if (status != 0) return -1;
+        r->slices = slices;
+        r->decisions = decisions;
+        r->allocations = allocations - before;
+    }
+
+    qsort(times, r->runs, sizeof(double), compare_double);
+    r->seconds = times[r->runs / 2];
+    free(times);
+    return 0;
+}
+
+// Each case runs in its own child so that its peak RSS is its own.
+static int run_isolated(bench_result* r, int nb_cpus){
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+
+    pid_t child = fork();
+    if (child < 0) return -1;
+    if (child == 0){
+        close(fds[0]);
+        int ok = run_case(r, nb_cpus) == 0 && write(fds[1], r, sizeof(*r)) == sizeof(*r);
+        _exit(ok ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t got = read(fds[0], r, sizeof(*r));
+    close(fds[0]);
+    int status;
+    struct rusage usage;
+    if (wait4(child, &status, 0, &usage) < 0 || got != sizeof(*r) || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return -1;
+    r->peak_rss_kb = usage.ru_maxrss;
+    return 0;
+}
+
+static void print_result(FILE* out, const bench_result* r){
+    fprintf(out, "{\"case\":\"%s\",\"algorithm\":\"%s\",\"processes\":%d,\"events_per_process\":%d,"
+                 "\"quantum\":%d,\"runs\":%d,\"seconds\":%.6f,\"slices\":%lld,\"decisions\":%lld,"
+                 "\"slices_per_sec\":%.0f,\"ns_per_decision\":%.1f,\"peak_rss_kb\":%ld,\"allocations\":%lld}\n",
+            r->name, r->algorithm, r->processes, r->events, r->quantum, r->runs, r->seconds, r->slices,
+            r->decisions, r->slices / r->seconds, r->decisions ? r->seconds * 1e9 / r->decisions : 0.0,
+            r->peak_rss_kb, r->allocations);
+}
+
+static int read_number(const char* line, const char* key, double* value){
+    const char* p = strstr(line, key);
+    return p != NULL && sscanf(p + strlen(key), "%lf", value) == 1;
+}
+
+// Compares slices/sec with the same cases of an earlier run.
+// Returns the number of cases slower by more than threshold percent.
+static int compare_baseline(const char* path, const bench_result* results, int n, double threshold){
+    FILE* f = fopen(path, "r");
+    if (f == NULL){
+        fprintf(stderr, "Error: cannot open baseline %s\n", path);
+        return -1;
+    }
+
+    int regressions = 0;
+    char line[1024];
+    fprintf(stderr, "\n%-44s %14s %14s %8s\n", "case", "baseline/s", "now/s", "change");
+    while (fgets(line, sizeof(line), f) != NULL){
+        const char* name = strstr(line, "\"case\":\"");
+        double base;
+        if (name == NULL || !read_number(line, "\"slices_per_sec\":", &base) || base <= 0)
+            continue;
+        name += strlen("\"case\":\"");
+        const char* end = strchr(name, '"');
+        if (end == NULL) continue;
+
+        for (int i = 0; i < n; i++){
+            const bench_result* r = &results[i];
+            if (strlen(r->name) != (size_t)(end - name) || strncmp(r->name, name, end - name) != 0)
+                continue;
+            double current = r->slices / r->seconds;
+            double change = (current - base) / base * 100;
+            int slower = change < -threshold;
+            regressions += slower;
+            fprintf(stderr, "%-44s %14.0f %14.0f %+7.1f%%%s\n", r->name, base, current, change,
+                    slower ? "  REGRESSION" : "");
+        }
+    }
+    fclose(f);
+    return regressions;
+}
+
+static void usage(const char* prog){
+    fprintf(stderr, "Usage: %s [--sizes N,N,...] [--runs N] [--cpus N] [--baseline FILE] [--threshold PCT]\n", prog);
+    fprintf(stderr, "\nRuns every algorithm on synthetic workloads and prints one JSON line per case.\n");
+    fprintf(stderr, "With --baseline, compares slices/sec against an earlier output and exits 2\n");
+    fprintf(stderr, "when a case got slower by more than the threshold (default %.0f%%).\n", DEFAULT_THRESHOLD);
+}
+
+int main(int argc, char* argv[]){
+    int sizes[16] = { 100, 10000, 1000000 };
+    int nb_sizes = 3;
+    int runs = DEFAULT_RUNS;
+    int nb_cpus = 1;
+    const char* baseline = NULL;
+    double threshold = DEFAULT_THRESHOLD;
+
+    for (int i = 1; i < argc; i++){
+        if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc){
+            nb_sizes = 0;
+            for (char* tok = strtok(argv[++i], ", "); tok != NULL && nb_sizes < 16; tok = strtok(NULL, ", "))
+                sizes[nb_sizes++] = atoi(tok);
+        }else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc){
+            runs = atoi(argv[++i]);
+        }else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc){
+            nb_cpus = atoi(argv[++i]);
+        }else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc){
+            baseline = argv[++i];
+        }else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc){
+            threshold = atof(argv[++i]);
+        }else{
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (runs < 1 || nb_cpus < 1 || nb_sizes == 0){
+        usage(argv[0]);
+        return 1;
+    }
+
+    static bench_result results[MAX_CASES];
+    int n = 0;
+    for (int s = 0; s < nb_sizes; s++){
+        for (size_t a = 0; a < sizeof(algorithms) / sizeof(algorithms[0]); a++){
+            for (size_t d = 0; d < sizeof(densities) / sizeof(densities[0]); d++){
+                // Only Round Robin reads the quantum.
+                size_t nb_quanta = strcmp(algorithms[a], "RoundRobin") == 0 ? sizeof(quanta) / sizeof(quanta[0]) : 1;
+                for (size_t q = 0; q < nb_quanta && n < MAX_CASES; q++){
+                    bench_result* r = &results[n];
+                    r->algorithm = algorithms[a];
+                    r->processes = sizes[s];
+                    r->events = densities[d];
+                    r->quantum = quanta[q];
+                    r->runs = runs;
+                    snprintf(r->name, sizeof(r->name), "%s/n=%d/events=%d/q=%d",
+                             r->algorithm, r->processes, r->events, r->quantum);
+                    fprintf(stderr, "%-44s ", r->name);
+                    if (run_isolated(r, nb_cpus) != 0){
+                        fprintf(stderr, "failed\n");
+                        return 1;
+                    }
+                    fprintf(stderr, "%12.0f slices/s %8.1f ns/decision\n",
+                            r->slices / r->seconds, r->seconds * 1e9 / (r->decisions ? r->decisions : 1));
+                    print_result(stdout, r);
+                    fflush(stdout);
+                    n++;
+                }
+            }
+        }
+    }
+
+    if (baseline != NULL){
+        int regressions = compare_baseline(baseline, results, n, threshold);
+        if (regressions != 0) return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+typedef struct arena_block{
+    struct arena_block* next;
+    size_t size;
+    size_t used;
+} arena_block;
+
+/* Bump allocator: allocations are never freed one by one, only all at once. */
+typedef struct arena{
+    arena_block* head;
+    size_t block_size;
+} arena;
+
+arena* create_arena(size_t block_size);
+void* arena_alloc(arena* a, size_t size);
+void* arena_calloc(arena* a, size_t count, size_t size);
+void arena_reset(arena* a);
+void free_arena(arena* a);
+
+#endif
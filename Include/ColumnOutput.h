@@ -0,0 +1,67 @@
+#ifndef COLUMN_OUTPUT_H
+#define COLUMN_OUTPUT_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "Utils.h"
+#include "Intern.h"
+
+#define COLUMNS_MAGIC "SCHC"
+#define COLUMNS_VERSION 1
+#define COLUMNS_MIME "application/vnd.scheduler.columns"
+
+/*
+ * Columnar schedule in host byte order (little-endian on every platform we
+ * build for), meant to be viewed in place as typed arrays:
+ *
+ *   header         64 bytes, below
+ *   process table  int32 pid[P], name[P], arrival[P], exec_time[P], priority[P]
+ *   slice table    int32 pid[S], ts[S], te[S], cpu[S], first_event[S + 1]
+ *   event table    int32 time[E], comment[E]; slice i owns events
+ *                  first_event[i] .. first_event[i + 1] - 1, time is wall-clock
+ *   string table   int32 offset[N + 1] into the blob; string 0 is ""
+ *   string blob    strings_size bytes of UTF-8, not NUL-terminated
+ *
+ * name and comment are string ids. The offsets delimit the strings, so they
+ * are stored as they are, unescaped. Every section starts 4-byte aligned.
+ */
+typedef struct columns_header{
+    char magic[4];
+    uint32_t version;
+    uint32_t nb_processes;
+    uint32_t nb_slices;
+    uint32_t nb_events;
+    uint32_t nb_strings;
+    uint32_t strings_size;
+    uint32_t nb_cpus;
+    char algorithm[32];
+} columns_header;
+
+typedef struct int_column{
+    int32_t* v;
+    size_t n;
+    size_t cap;
+} int_column;
+
+/* Collects the slices as columns; the file is written by columns_writer_finish. */
+typedef struct columns_writer{
+    FILE* out;
+    columns_header h;
+    const process* processes;
+    const comment_table* comments;
+    int_column pid;
+    int_column ts;
+    int_column te;
+    int_column cpu;
+    int_column first_event;
+    int_column event_time;
+    int_column event_comment;
+} columns_writer;
+
+columns_writer* columns_writer_create(FILE* out, const char* algorithm, const process* processes, int nbProc, int nb_cpus);
+int columns_write_execute(void* ctx, const execute* e);
+/* Comment ids are resolved in comments instead of the process-wide table. */
+void columns_writer_set_comments(columns_writer* w, const comment_table* comments);
+int columns_writer_finish(columns_writer* w);
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+typedef enum ContentEncoding {
+    ENCODING_IDENTITY,
+    ENCODING_GZIP,
+    ENCODING_DEFLATE
+} ContentEncoding;
+
+/* Pulls up to max uncompressed bytes; 0 at the end, -1 on error. */
+typedef ssize_t (*CompressorSource)(void *cls, char *buf, size_t max);
+
+typedef struct Compressor Compressor;
+
+/*
+ * zlib compression of HTTP responses, negotiated per request from its
+ * Accept-Encoding header. Level 0 turns it off; bodies shorter than
+ * min_size are always sent as they are.
+ */
+void CompressionInit(int level, size_t min_size);
+size_t CompressionMinSize(void);
+ContentEncoding NegotiateEncoding(const char *accept_encoding);
+const char* EncodingName(ContentEncoding encoding);
+
+/* Whole-buffer compression; NULL when it fails or does not shrink the body. */
+char* CompressBuffer(const char *data, size_t size, ContentEncoding encoding, size_t *compressed_size);
+
+/*
+ * Streamed compression: CompressorRead fills out with compressed bytes,
+ * pulling input from source as it needs it. Returns 0 once the compressed
+ * stream is complete, -1 on error.
+ */
+Compressor* CreateCompressor(ContentEncoding encoding);
+ssize_t CompressorRead(Compressor *c, CompressorSource source, void *cls, char *out, size_t max);
+void FreeCompressor(Compressor *c);
+
+#endif
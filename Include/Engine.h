@@ -0,0 +1,83 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "Utils.h"
+#include "Arena.h"
+
+// Each CPU and each Multilevel priority level costs the run its own state,
+// so requests are held to these.
+#define MAX_CPUS 1024
+#define MAX_PRIORITY 4096
+
+typedef struct sim_params{
+    int quantum;
+    int nb_priority;
+    int cpu_usage_limit;
+    int cpus;
+} sim_params;
+
+/*
+ * A scheduling policy plugged into the discrete-event engine. The engine owns
+ * the clock, the arrivals and the slices; the policy only owns its ready
+ * structures. Optional callbacks may be NULL.
+ *
+ *  params      NULL-terminated names of the sim_params fields it reads
+ *  create      builds one CPU's state inside the run arena; it is released
+ *              with the run, so there is no destroy callback
+ *  preemptive  segments end at every arrival so preempt() can react to it
+ *  coalesce    back-to-back slices of the same process are merged
+ *  enqueue     a process became ready (arrival); 0 once queued, 1 when the
+ *              policy leaves it out (it never runs), negative when it could
+ *              not be queued, which fails the run
+ *  pick_next   process to dispatch on an idle CPU, NULL if none is ready
+ *  time_slice  longest run granted to a freshly dispatched process
+ *  on_tick     the running process just ran `ran` units; new_slice is 0 when
+ *              the run was merged into the previous slice
+ *  preempt     the running process still has work after a segment: return
+ *              nonzero to take the CPU away (the policy requeues it itself),
+ *              negative when requeueing it failed, which fails the run
+ *  steal       move one queued process other than `running` from the victim
+ *              CPU's state to the thief's and return it, NULL if none or if
+ *              it could not be moved (it then stays with the victim)
+ *
+ * With several CPUs every CPU gets its own policy state (its run queue).
+ * Arrivals go to the least loaded CPU and an idle CPU steals from the CPU
+ * with the most waiting processes.
+ */
+typedef struct policy{
+    const char* name;
+    const char* const* params;
+    int preemptive;
+    int coalesce;
+    void* (*create)(const sim_params* params, arena* a);
+    int (*enqueue)(void* st, process* p);
+    process* (*pick_next)(void* st);
+    int (*time_slice)(void* st, process* p);
+    void (*on_tick)(void* st, process* p, int ran, int new_slice);
+    int (*preempt)(void* st, process* p, int expired);
+    process* (*steal)(void* victim, void* thief, process* running);
+} policy;
+
+/*
+ * Receives every slice as soon as the engine closes it. The slice is only
+ * valid during the call; its events live in the process and outlast the run.
+ * A nonzero return stops the run.
+ */
+typedef struct slice_sink{
+    int (*emit)(void* ctx, const execute* e);
+    void* ctx;
+} slice_sink;
+
+typedef struct sim sim;
+
+sim* sim_create(const policy* pol, process* processes, int n, const sim_params* params);
+int sim_run(sim* s, slice_sink* sink);
+/* sim_run in pieces, for callers that pull slices: sim_step returns 1 while running. */
+void sim_start(sim* s, slice_sink* sink);
+int sim_step(sim* s);
+void sim_free(sim* s);
+
+execute* simulate(const policy* pol, process* processes, int n, const sim_params* params, int* out_cnt);
+const policy* find_policy(const char* name);
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <stdint.h>
+#include "Utils.h"
+
+typedef enum gen_arrivals{
+    ARRIVALS_POISSON,
+    ARRIVALS_BURSTY
+} gen_arrivals;
+
+typedef enum gen_exec{
+    EXEC_EXPONENTIAL,
+    EXEC_PARETO,
+    EXEC_BIMODAL
+} gen_exec;
+
+/*
+ * Synthetic workload description. Times are in scheduler time units.
+ *
+ *  arrivals      Poisson at `rate`, or bursty: a two-state Markov-modulated
+ *                Poisson process that arrives at `rate` between bursts and at
+ *                `burst_rate` during them; both states last an exponential
+ *                time of mean `calm_length` and `burst_length`
+ *  exec          exponential of mean `exec_mean`; Pareto of minimum
+ *                `exec_mean` and shape `pareto_shape`; or bimodal, a share
+ *                `long_share` of exponential(`exec_long`) among
+ *                exponential(`exec_mean`)
+ *  exec_time     rounded up, at least 1 and at most `max_exec`
+ *  priority      uniform in [min_priority, max_priority]
+ *  events        Poisson count of mean `events_mean` per process, capped by
+ *                exec_time, at uniform offsets into its execution
+ */
+typedef struct gen_params{
+    uint64_t seed;
+    int nb_processes;
+    gen_arrivals arrivals;
+    double rate;
+    double burst_rate;
+    double calm_length;
+    double burst_length;
+    gen_exec exec;
+    double exec_mean;
+    double exec_long;
+    double long_share;
+    double pareto_shape;
+    int max_exec;
+    int min_priority;
+    int max_priority;
+    double events_mean;
+} gen_params;
+
+#define GEN_MAX_EVENTS_MEAN 64.0
+
+void gen_defaults(gen_params* params);
+/* -1, with the reason in *error, when a parameter is out of range. */
+int gen_check(const gen_params* params, const char** error);
+
+/*
+ * The same seed and parameters always give the same workload. Processes and
+ * events are one block, like the parser's output, so free() releases both.
+ * NULL on invalid parameters, on allocation failure or when the arrivals
+ * overflow an int.
+ */
+process* gen_workload(const gen_params* params);
+
+#endif
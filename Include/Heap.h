@@ -0,0 +1,33 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include "Arena.h"
+
+typedef int (*heap_cmp)(const void* a, const void* b);
+
+typedef struct heap_entry{
+    void* data;
+    unsigned long seq;
+} heap_entry;
+
+/* Binary min-heap ordered by cmp; entries comparing equal come out in push order. */
+typedef struct heap{
+    int sz;
+    int cap;
+    unsigned long seq;
+    heap_entry* entries;
+    heap_cmp cmp;
+    arena* a;
+} heap;
+
+heap* create_heap(heap_cmp cmp);
+heap* create_heap_in(arena* a, heap_cmp cmp);
+/* Returns -1, leaving the heap as it was, when it cannot grow. */
+int heap_push(heap* h, void* dataToPush);
+void heap_pop(heap* h);
+void* heap_top(heap* h);
+void* heap_take_last(heap* h);
+int heap_size(heap* h);
+void free_heap(heap* h);
+
+#endif
@@ -1,7 +1,18 @@
 #ifndef HTTP_SERVER_H
 #define HTTP_SERVER_H
 
+#include <stddef.h>
 
-int StartHttpServer(void);
+typedef struct ServerOptions {
+    size_t cache_bytes;
+    int http_threads;
+    int job_workers;
+    int job_queue_size;
+    size_t run_store_bytes;
+    int compression_level;
+    size_t compression_min_size;
+} ServerOptions;
+
+int StartHttpServer(const ServerOptions *options);
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Process-wide table of event comments. Equal strings share one id, and ids
+ * stay valid until the program exits. intern_comment() takes a lock;
+ * comment_text() does not, so output code can resolve ids from any thread.
+ * Only the CLI and trusted files intern here, since the table never shrinks.
+ */
+uint32_t intern_comment(const char* text);
+uint32_t intern_comment_len(const char* text, size_t len);
+const char* comment_text(uint32_t id);
+uint32_t interned_count(void);
+
+/*
+ * A private table with the same ids scheme, for comments from untrusted
+ * input: it lives and dies with the request that filled it. No lock; one
+ * thread fills it before the run reads it. A NULL table stands for the
+ * process-wide one in comment_table_text() and comment_table_count().
+ */
+typedef struct comment_table comment_table;
+
+comment_table* create_comment_table(void);
+uint32_t comment_table_intern(comment_table* t, const char* text, size_t len);
+const char* comment_table_text(const comment_table* t, uint32_t id);
+uint32_t comment_table_count(const comment_table* t);
+void free_comment_table(comment_table* t);
+
+#endif
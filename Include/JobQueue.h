@@ -0,0 +1,60 @@
+#ifndef JOB_QUEUE_H
+#define JOB_QUEUE_H
+
+#include <stddef.h>
+#include "SchedulerExecutor.h"
+#include "Trace.h"
+#include "Lod.h"
+
+typedef enum JobState {
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_DONE,
+    JOB_FAILED,
+    JOB_CANCELLED
+} JobState;
+
+/* A page of a run's slices; from and to default to the run's start and end. */
+typedef struct SliceWindow {
+    int has_from;
+    int from;
+    int has_to;
+    int to;
+    int limit;
+    int has_after;
+    trace_cursor after;
+} SliceWindow;
+
+typedef enum JobLookup {
+    JOB_FOUND,
+    JOB_NOT_FOUND,
+    JOB_PENDING
+} JobLookup;
+
+/*
+ * Background runs for /api/jobs. Submitted requests wait in a bounded FIFO
+ * until one of the workers picks them up; finished jobs are kept for
+ * retrieval until newer ones push them out. Cancelling a running job stops
+ * the simulation at its next slice.
+ *
+ * A job that finishes keeps its slices in a trace, and their level-of-detail
+ * pyramid, for /api/runs while they fit in run_store_bytes along with the
+ * other runs' (0 keeps none); the oldest runs lose theirs first.
+ */
+int JobQueueStart(int workers, int capacity, size_t run_store_bytes);
+void JobQueueStop(void);
+
+/* Takes ownership of req. Returns -1 when the queue is full. */
+int SubmitJob(ScheduleRequest *req, unsigned long *id);
+
+char* GetJobStatusJson(unsigned long id);
+JobLookup GetJobResult(unsigned long id, char **result, JobState *state);
+int CancelJob(unsigned long id);
+/* *json is NULL for a finished run whose slices were not kept. */
+JobLookup GetRunSlices(unsigned long id, const SliceWindow *window, char **json);
+/* The window's buckets, at most pixels per CPU; the window's limit and after are unused. */
+JobLookup GetRunLod(unsigned long id, const SliceWindow *window, int pixels, char **json);
+const char* JobStateName(JobState state);
+void JobQueueCounts(int *queued, int *running);
+
+#endif
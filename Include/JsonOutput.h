@@ -0,0 +1,78 @@
+#ifndef JSON_OUTPUT_H
+#define JSON_OUTPUT_H
+
+#include <stdio.h>
+#include "Utils.h"
+#include "Stats.h"
+#include "RunMetrics.h"
+#include "Intern.h"
+
+#define JSON_SAMPLE_EVERY 100
+
+typedef enum json_detail{
+    DETAIL_FULL,
+    DETAIL_SUMMARY,
+    DETAIL_SAMPLED
+} json_detail;
+
+/* A held slice keeps the process as it was when the slice was emitted. */
+typedef struct sampled_slice{
+    execute e;
+    process p;
+    int index;
+} sampled_slice;
+
+/* Streams the scheduler_cli JSON document: header, one execute per slice as it is produced, footer. */
+typedef struct json_writer{
+    FILE* out;
+    int count;
+    int nb_cpus;
+    int* busy;
+    int* slices;
+    int* end;
+    char* buf;
+    size_t len;
+    sched_stats* stats;
+    run_metrics* metrics;
+    json_detail detail;
+    int written;
+    int sample_every;
+    int sample_size;
+    uint64_t rng;
+    sampled_slice* reservoir;
+    int reservoir_cap;
+    const comment_table* comments;
+    const process* processes;
+    int nb_processes;
+} json_writer;
+
+json_writer* json_writer_create(FILE* out, const char* algorithm, int nbProc, int nb_cpus);
+/*
+ * Compact schema: the process table once, then each slice as
+ * {"pid","ts","te","cpu","offset","event_ids"} without indentation. event_ids
+ * index the process's events, whose wall-clock time is ts + t - offset. The
+ * text is staged in one buffer and written with a single fwrite per block.
+ * The process table goes out with the first slice, so the setters below
+ * still apply to it.
+ */
+json_writer* json_writer_create_compact(FILE* out, const char* algorithm, const process* processes, int nbProc, int nb_cpus);
+int json_write_execute(void* ctx, const execute* e);
+/* The document ends with a "stats" block; the time spent finishing counts as serialize. */
+void json_writer_set_stats(json_writer* w, sched_stats* stats);
+/* Comment ids are resolved in comments instead of the process-wide table. */
+void json_writer_set_comments(json_writer* w, const comment_table* comments);
+/* Folds every slice into run metrics, written as a final "metrics" block. Call after sim_create. */
+int json_writer_enable_metrics(json_writer* w, const process* processes, int nbProc);
+/*
+ * Other detail levels end the document with "detail" and "totalSlices".
+ * Summary writes no slice and leaves the per-process list out of the
+ * metrics. Sampled writes every k-th slice (every JSON_SAMPLE_EVERY-th
+ * unless told otherwise) or, given a size, a uniform
+ * reservoir sample of that many slices held until the end; either way the
+ * slices keep their order.
+ */
+void json_writer_set_summary(json_writer* w);
+int json_writer_set_sampling(json_writer* w, int every, int size, uint64_t seed);
+int json_writer_finish(json_writer* w);
+
+#endif
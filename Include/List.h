@@ -2,6 +2,7 @@
 #define LIST_H
 
 #include "Utils.h"
+#include "Arena.h"
 
 typedef struct node{
     void* data;
@@ -9,19 +10,27 @@ typedef struct node{
     struct node* suiv;
 } node;
 
+/*
+ * Nodes come from the arena when one is given; removed nodes are kept for reuse.
+ * add_head and add_tail return nonzero when no node could be allocated.
+ */
 typedef struct list{
     int sz;
     node* head;
     node* tail;
+    arena* a;
+    node* spare;
 } list;
 
 list* create_list();
-void add_head(list *l, void *dataToAdd);
-void add_tail(list *l, void *dataToAdd);
+list* create_list_in(arena* a);
+int add_head(list *l, void *dataToAdd);
+int add_tail(list *l, void *dataToAdd);
 void del_head(list *l);
 void del_tail(list *l);
 void* get_head(list *l);
 void* get_tail(list *l);
 int getsz(list *l);
+void free_list(list *l);
 
 #endif
\ No newline at end of file
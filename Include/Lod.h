@@ -0,0 +1,66 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include "Trace.h"
+
+#define LOD_TOP 4
+
+typedef struct lod_share{
+    int pid;
+    int busy;
+} lod_share;
+
+/* What one CPU did over a bucket of time. */
+typedef struct lod_bucket{
+    long long busy;
+    /* Slices starting in the bucket and events happening in it. */
+    int slices;
+    int events;
+    /*
+     * The processes that ran the longest in the bucket, longest first, and
+     * for how long; unused entries have pid 0.
+     */
+    lod_share top[LOD_TOP];
+} lod_bucket;
+
+/*
+ * A level-of-detail pyramid over a finished trace, for drawing a window of
+ * any length in a bounded number of buckets. Level 0 splits the run, from its
+ * start, into buckets of 1 << base_shift time units, about one per four
+ * slices of a CPU; each level above merges pairs of buckets, up to one bucket
+ * for the run. The pyramid takes about one bucket per two slices.
+ *
+ * Level 0 keeps the exact LOD_TOP longest-running processes of each bucket.
+ * Above it a pair's list is merged from its halves' lists, a process's time
+ * summed over the halves that kept it, so the list is approximate there: a
+ * process that ran a little in many buckets can be missed, and a time is
+ * never more than the process really ran.
+ */
+typedef struct lod_pyramid{
+    int nb_cpus;
+    int origin;
+    int base_shift;
+    int nb_levels;
+    int* level_size;
+    int* level_offset;
+    /* Per CPU, every level's buckets one after the other. */
+    lod_bucket** lanes;
+} lod_pyramid;
+
+lod_pyramid* lod_build(const trace* t);
+/*
+ * The finest level that covers [from, to) in at most pixels buckets per CPU,
+ * with the range of its buckets the window touches in *first .. *last
+ * (empty when *last < *first).
+ */
+int lod_level(const lod_pyramid* p, int from, int to, int pixels, int* first, int* last);
+long long lod_width(const lod_pyramid* p, int level);
+const lod_bucket* lod_buckets(const lod_pyramid* p, int cpu, int level);
+size_t lod_bytes(const lod_pyramid* p);
+/* One bucket starting at t as a JSON object, its used top entries as a list. */
+void lod_write_json(FILE* out, const lod_bucket* b, long long t);
+void lod_free(lod_pyramid* p);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum MetricsEndpoint {
+    ENDPOINT_SCHEDULE,
+    ENDPOINT_JOBS,
+    ENDPOINT_JOB,
+    ENDPOINT_RUN,
+    ENDPOINT_ALGORITHMS,
+    ENDPOINT_CACHE,
+    ENDPOINT_METRICS,
+    ENDPOINT_OTHER,
+    NB_ENDPOINTS
+} MetricsEndpoint;
+
+/*
+ * Server counters for /api/metrics. Every thread counts into its own block,
+ * so recording is a plain store with no lock or atomic read-modify-write;
+ * GetMetricsText sums the blocks of all threads that ever recorded.
+ */
+uint64_t MetricsNow(void);
+void MetricsRequestStarted(void);
+void MetricsRequestFinished(MetricsEndpoint endpoint, unsigned int status, uint64_t micros);
+void MetricsBytesSent(size_t bytes);
+void MetricsSchedulerRun(const char *algorithm, uint64_t micros, unsigned long slices);
+
+/* Prometheus text exposition format. */
+char* GetMetricsText(void);
+
+#endif
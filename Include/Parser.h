@@ -1,8 +1,16 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <stdio.h>
+#include <stddef.h>
 #include "Utils.h"
 
-int parser(FILE *f, process tab[], int *nbProc);
+/*
+ * Loads a text workload into one malloc'ed block holding the processes and
+ * their events: free(*tab) releases everything. Returns -1 on a malformed
+ * line or when memory runs out.
+ */
+int parser(FILE *f, process** tab, int *nbProc);
+int parse_workload(const char* buf, size_t size, process** tab, int* nbProc);
 
 #endif
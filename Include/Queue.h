@@ -5,10 +5,14 @@
 
 typedef list* queue;
 
+// push returns NULL when the element could not be added.
+
 queue create_queue();
+queue create_queue_in(arena* a);
 queue push(queue q, void* dataToPush);
 queue pop(queue q);
 void* front(queue q);
 int size(queue q);
+void free_queue(queue q);
 
 #endif
\ No newline at end of file
@@ -1,11 +1,15 @@
 #ifndef REQUEST_HANDLER_H
 #define REQUEST_HANDLER_H
 
+#include <stdint.h>
 #include <microhttpd.h>
 
 struct ConnectionInfo {
     char *data;
     size_t size;
+    int endpoint;
+    unsigned int status;
+    uint64_t start;
 };
 
 
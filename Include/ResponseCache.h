@@ -0,0 +1,39 @@
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <stddef.h>
+#include "SchedulerExecutor.h"
+
+typedef enum CacheOutcome {
+    CACHE_MISS,
+    CACHE_HIT,
+    CACHE_COALESCED
+} CacheOutcome;
+
+/* A run this caller owns until it hands the result to ResponseCacheFinish. */
+typedef struct CacheEntry CacheTicket;
+
+/*
+ * LRU cache of /api/schedule responses keyed by a canonical form of the
+ * request: algorithm, the parameters that algorithm reads, cpus and the
+ * processes. Identical requests arriving while one is running wait for it
+ * instead of running again; when it keeps no document (too large, or no
+ * budget at all) they all run at once on their own. Failed runs are never
+ * cached.
+ *
+ * ResponseCacheLookup returns a HIT or COALESCED document in *response and
+ * its length in *size. On a MISS the caller runs the request and, when
+ * *ticket is set, must pass the outcome to ResponseCacheFinish: the document
+ * (owned by the cache from then on, NUL-terminated past size, NULL when none
+ * was kept) and whether it may be stored. Waiters block their own thread,
+ * so the ticket must be finished without waiting on anything that may need
+ * one of those threads, such as the response callback of a connection.
+ */
+void ResponseCacheInit(size_t budget_bytes);
+CacheOutcome ResponseCacheLookup(const ScheduleRequest *req, char **response, size_t *size, CacheTicket **ticket);
+void ResponseCacheFinish(CacheTicket *ticket, char *response, size_t size, int keep);
+size_t ResponseCacheEntryLimit(void);
+char* GetCacheStatsJson(void);
+const char* CacheOutcomeName(CacheOutcome outcome);
+
+#endif 
@@ -0,0 +1,63 @@
+#ifndef RUN_METRICS_H
+#define RUN_METRICS_H
+
+#include <stdio.h>
+#include "Utils.h"
+
+typedef struct proc_metrics{
+    int first_start;
+    int completion;
+    int last_end;
+    int last_cpu;
+    int preemptions;
+} proc_metrics;
+
+/*
+ * Scheduling metrics folded in one slice at a time, so nothing but the
+ * per-process state below is kept, however long the trace. Create it after
+ * sim_create, which reorders the processes: slices are matched to their
+ * process by position in that array.
+ *
+ * A process is preempted when one of its slices does not pick up where its
+ * previous one ended, on the same CPU. Times run from the first arrival to
+ * the last slice; the processes still running when a run stops count for
+ * utilization but not for the averages.
+ */
+typedef struct run_metrics{
+    const process* processes;
+    int n;
+    int nb_cpus;
+    proc_metrics* procs;
+    int start;
+    int end;
+    long long busy;
+} run_metrics;
+
+typedef struct metrics_summary{
+    int completed;
+    int makespan;
+    long long busy;
+    long long idle;
+    double utilization;
+    double throughput;
+    double avg_waiting;
+    double avg_turnaround;
+    double avg_response;
+    int max_waiting;
+    int max_turnaround;
+    int max_response;
+    long long preemptions;
+    /* Jain's index over each finished process's exec_time / turnaround. */
+    double fairness;
+} metrics_summary;
+
+run_metrics* run_metrics_create(const process* processes, int n, int nb_cpus);
+void run_metrics_add(run_metrics* m, const execute* e);
+/* run_metrics_add as a slice_sink callback. */
+int run_metrics_emit(void* ctx, const execute* e);
+void run_metrics_summarize(const run_metrics* m, metrics_summary* s);
+/* The summary, then with per_process one entry per process; unknown times are null. */
+void run_metrics_write_json(FILE* out, const run_metrics* m, int per_process);
+void run_metrics_free(run_metrics* m);
+
+#endif
@@ -2,6 +2,12 @@
 #define SCHEDULER_H
 
 #include "Utils.h"
+#include "Engine.h"
+
+extern const policy fifo_policy;
+extern const policy rr_policy;
+extern const policy pp_policy;
+extern const policy multilevel_policy;
 
 execute* fifo_scheduler(process* processes, int n, int *out_cnt);
 execute* rr_scheduler(process* processes, int n, int Q, int *out_cnt);
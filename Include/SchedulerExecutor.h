@@ -1,25 +1,63 @@
 #ifndef SCHEDULER_EXECUTOR_H
 #define SCHEDULER_EXECUTOR_H
 
+#include <sys/types.h>
+#include "Engine.h"
+#include "Stats.h"
+#include "JsonOutput.h"
+#include "Trace.h"
 
-int CreateConfigFileFromJson(
-    const char *json_data,
-    char *config_path,
-    size_t config_path_size,
-    char *algorithm,
-    size_t algorithm_size,
-    int *quantum,
-    int *cpu_limit,
-    int *nb_priority
-);
-
-
-char* RunSchedulerAndCaptureOutput(
-    const char *config_path,
-    const char *algorithm,
-    int quantum,
-    int cpu_limit,
-    int nb_priority
-);
-
-#endif 
\ No newline at end of file
+#define MAX_SAMPLE_SIZE 1000000
+
+typedef enum ScheduleFormat {
+    FORMAT_JSON,
+    FORMAT_COMPACT,
+    FORMAT_COLUMNS
+} ScheduleFormat;
+
+/*
+ * A decoded /api/schedule body; processes and their events are one allocation,
+ * and the events' comment ids index the request's own comments table.
+ * stats is only ever set in SCHED_STATS builds, parse_ns only measured there.
+ * metrics asks the JSON documents for a "metrics" block; summary implies it.
+ * A sampled request keeps every sample_every-th slice, or with sample_size a
+ * reservoir of that many drawn with sample_seed.
+ */
+typedef struct ScheduleRequest {
+    char algorithm[50];
+    sim_params params;
+    process *processes;
+    int nb_processes;
+    comment_table *comments;
+    ScheduleFormat format;
+    int stats;
+    int metrics;
+    json_detail detail;
+    int sample_every;
+    int sample_size;
+    uint64_t sample_seed;
+    uint64_t parse_ns;
+} ScheduleRequest;
+
+
+int ParseScheduleRequest(const char *json_data, ScheduleRequest *req);
+
+char* RunScheduler(const ScheduleRequest *req, int *failed);
+
+/* The slices also go to slices when it is given; it is finished here. */
+char* RunSchedulerCancellable(const ScheduleRequest *req, const int *cancel, trace *slices, int *failed);
+
+/*
+ * A run rendered on demand: each read steps the simulation just far enough to
+ * fill the caller's buffer. Opening takes over req's processes and comments; on failure
+ * *error holds the error document and req is left to the caller.
+ */
+typedef struct ScheduleStream ScheduleStream;
+
+ScheduleStream* OpenScheduleStream(ScheduleRequest *req, char **error);
+ssize_t ReadScheduleStream(ScheduleStream *st, char *buf, size_t max);
+void CloseScheduleStream(ScheduleStream *st);
+
+void FreeScheduleRequest(ScheduleRequest *req);
+
+#endif 
@@ -0,0 +1,52 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * Counters and phase timings of one run, collected only when the tree is
+ * built with -DSCHED_STATS (make STATS=1). Instrumented code counts into
+ * the calling thread's current stats, set with stats_attach; the engine
+ * attaches a run's stats on each step, so interleaved runs stay apart.
+ * Without SCHED_STATS every STATS_* macro expands to nothing.
+ */
+typedef struct sched_stats{
+    uint64_t context_switches;
+    uint64_t queue_pushes;
+    uint64_t queue_pops;
+    uint64_t demotions;
+    uint64_t events_extracted;
+    uint64_t slices;
+    uint64_t allocations;
+    uint64_t arena_blocks;
+    uint64_t parse_ns;
+    uint64_t sort_ns;
+    uint64_t run_ns;
+    uint64_t emit_ns;
+    uint64_t finish_ns;
+} sched_stats;
+
+#ifdef SCHED_STATS
+#define STATS_ENABLED 1
+extern __thread sched_stats* stats_current;
+#define STATS_INC(field) do { if (stats_current) stats_current->field++; } while (0)
+#define STATS_ADD(field, n) do { if (stats_current) stats_current->field += (n); } while (0)
+#define STATS_START(var) uint64_t var = stats_now()
+#define STATS_TIME(field, var) STATS_ADD(field, stats_now() - (var))
+#else
+#define STATS_ENABLED 0
+#define STATS_INC(field) ((void)0)
+#define STATS_ADD(field, n) ((void)0)
+#define STATS_START(var) ((void)0)
+#define STATS_TIME(field, var) ((void)0)
+#endif
+
+uint64_t stats_now(void);
+/* Makes st the calling thread's current stats and returns the previous ones. */
+sched_stats* stats_attach(sched_stats* st);
+/* Simulate excludes the time spent in the sink; serialize is sink plus finish. */
+void stats_write_json(FILE* out, const sched_stats* st);
+void stats_print(FILE* out, const sched_stats* st);
+
+#endif
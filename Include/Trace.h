@@ -0,0 +1,71 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include "Utils.h"
+
+typedef struct trace_slice{
+    int pid;
+    int ts;
+    int te;
+    int cpu;
+    int offset;
+} trace_slice;
+
+/*
+ * One CPU's slices and the times of the events they ran into. Slices never
+ * overlap, so sorted by ts they are sorted by te too.
+ */
+typedef struct trace_lane{
+    trace_slice* slices;
+    int n;
+    int cap;
+    int* events;
+    int nb_events;
+    int events_cap;
+    int sorted;
+} trace_lane;
+
+/*
+ * A finished run's slices, kept per CPU for windowed reads. A window
+ * [from, to) holds the slices with ts < to and te > from: on each lane they
+ * are one contiguous range found by two binary searches, so counting a
+ * window takes O(cpus log n) and reading k slices of it O(cpus log n + k log cpus).
+ *
+ * Past max_bytes of slices and events (0 for no limit) or on a failed
+ * allocation the trace stops growing and is marked truncated instead of
+ * stopping the run.
+ */
+typedef struct trace{
+    int nb_cpus;
+    trace_lane* lanes;
+    long long n;
+    size_t used;
+    size_t max_bytes;
+    int start;
+    int end;
+    int truncated;
+} trace;
+
+/* Where the previous page stopped: the last slice read, ordered by ts then cpu. */
+typedef struct trace_cursor{
+    int ts;
+    int cpu;
+} trace_cursor;
+
+trace* trace_create(int nb_cpus, size_t max_bytes);
+void trace_add(trace* t, const execute* e);
+/* trace_add as a slice_sink callback. */
+int trace_emit(void* ctx, const execute* e);
+/* Sorts the lanes a run emitted out of order and gives back their spare room. Call once the run ends. */
+void trace_finish(trace* t);
+long long trace_count(const trace* t, int from, int to);
+/*
+ * Up to limit slices of [from, to) in (ts, cpu) order, starting after the
+ * cursor when one is given. Returns how many were written to out.
+ */
+int trace_query(const trace* t, int from, int to, const trace_cursor* after, trace_slice* out, int limit);
+size_t trace_bytes(const trace* t);
+void trace_free(trace* t);
+
+#endif
@@ -1,10 +1,13 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stdint.h>
 
+// comment_id is resolved with comment_text() from Intern.h, or in the
+// comment_table the processes were parsed with (server requests).
 typedef struct {
     int t; 
-    char comment[250];
+    uint32_t comment_id;
 } event;
 
 typedef struct{
@@ -18,22 +21,30 @@ typedef struct{
     int priority;
     int nbEvents;
     event* events;
+    int next_event;
 } process;
 
 
+/*
+ * events points into p->events (sorted by t) and keeps the process-relative
+ * times; offset is the work the process had done when the slice started, so
+ * event_time() gives the wall-clock time.
+ */
 typedef struct {
     process* p;
     int ts;
     int te;
     int event_count;
     event* events;
+    int cpu;
+    int offset;
 } execute;
 
 int compare_event(const void* a, const void* b);
-event* getEvents(process p, int tl, int tr, int *out_cnt);
+void sort_events(process* p);
+int event_time(const execute* e, const event* ev);
 int compare_process(const void* a, const void* b);
 int compare_by_priority(const void*a, const void* b);
-execute* make_execute(process* p, int tl, int tr, int event_count, event* events);
-process* make_process(process* p);
+int compare_by_rem_time(const void* a, const void* b);
 
 #endif
\ No newline at end of file
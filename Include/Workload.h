@@ -0,0 +1,67 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "Utils.h"
+
+#define WORKLOAD_MAGIC "SWKL"
+#define WORKLOAD_VERSION 2
+
+/*
+ * Binary workload file, native byte order, every section 8-byte aligned:
+ *
+ *   header
+ *   process table  nb_processes workload_record
+ *   event table    nb_events workload_event, each process's events after
+ *                  the previous one's, sorted by t; comment indexes the
+ *                  string table, whose entry 0 is ""
+ *   string table   nb_strings uint32 offsets into the text blob
+ *   text blob      NUL-terminated comments
+ *
+ * process_size and event_size are the record sizes; a file with other sizes
+ * is rejected rather than misread.
+ */
+typedef struct workload_record{
+    int32_t pid;
+    int32_t ppid;
+    char name[20];
+    int32_t arrival;
+    int32_t exec_time;
+    int32_t priority;
+    int32_t nb_events;
+} workload_record;
+
+typedef struct workload_event{
+    int32_t t;
+    uint32_t comment;
+} workload_event;
+
+typedef struct workload_header{
+    char magic[4];
+    uint32_t version;
+    uint32_t process_size;
+    uint32_t event_size;
+    uint64_t nb_processes;
+    uint64_t nb_events;
+    uint64_t nb_strings;
+    uint64_t processes_off;
+    uint64_t events_off;
+    uint64_t strings_off;
+    uint64_t texts_off;
+    uint64_t file_size;
+} workload_header;
+
+/* Processes loaded from a text or binary file, events in the same block. */
+typedef struct workload{
+    process* processes;
+    int n;
+} workload;
+
+workload* workload_open(const char* path);
+void workload_close(workload* w);
+int workload_write_binary(FILE* out, const process* processes, int n);
+int workload_write_text(FILE* out, const process* processes, int n);
+
+#endif
@@ -0,0 +1,89 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../../Include/Arena.h"
+#include "../../Include/Stats.h"
+
+#define ARENA_ALIGN 16
+#define ARENA_MAX_BLOCK (16 * 1024 * 1024)
+
+static size_t align_up(size_t n){
+    return (n + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static size_t header_size(void){
+    return align_up(sizeof(arena_block));
+}
+
+static arena_block* new_block(size_t size){
+    arena_block* b = (arena_block*)malloc(header_size() + size);
+    if (b == NULL) return NULL;
+    STATS_INC(arena_blocks);
+    b->next = NULL;
+    b->size = size;
+    b->used = 0;
+    return b;
+}
+
+arena* create_arena(size_t block_size){
+    arena* a = (arena*)malloc(sizeof(arena));
+    if (a == NULL) return NULL;
+    a->block_size = align_up(block_size ? block_size : 4096);
+    a->head = new_block(a->block_size);
+    if (a->head == NULL){
+        free(a);
+        return NULL;
+    }
+    return a;
+}
+
+void* arena_alloc(arena* a, size_t size){
+    if (a == NULL) return NULL;
+    STATS_INC(allocations);
+    size = align_up(size ? size : 1);
+
+    arena_block* b = a->head;
+    if (b->used + size > b->size){
+        // Blocks double up to ARENA_MAX_BLOCK so a run needs O(log n) of them.
+        size_t next = b->size * 2 > ARENA_MAX_BLOCK ? ARENA_MAX_BLOCK : b->size * 2;
+        if (next < size) next = size;
+        b = new_block(next);
+        if (b == NULL) return NULL;
+        b->next = a->head;
+        a->head = b;
+    }
+
+    void* ptr = (char*)b + header_size() + b->used;
+    b->used += size;
+    return ptr;
+}
+
+void* arena_calloc(arena* a, size_t count, size_t size){
+    void* ptr = arena_alloc(a, count * size);
+    if (ptr != NULL)
+        memset(ptr, 0, count * size);
+    return ptr;
+}
+
+// Keeps only the newest (largest) block, emptied.
+void arena_reset(arena* a){
+    if (a == NULL) return;
+    arena_block* b = a->head->next;
+    while (b != NULL){
+        arena_block* nxt = b->next;
+        free(b);
+        b = nxt;
+    }
+    a->head->next = NULL;
+    a->head->used = 0;
+}
+
+void free_arena(arena* a){
+    if (a == NULL) return;
+    arena_block* b = a->head;
+    while (b != NULL){
+        arena_block* nxt = b->next;
+        free(b);
+        b = nxt;
+    }
+    free(a);
+}
@@ -0,0 +1,360 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "../../Include/Engine.h"
+#include "../../Include/Scheduler.h"
+#include "../../Include/Stats.h"
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define SIM_ARENA_BLOCK (64 * 1024)
+
+typedef struct cpu{
+    void* st;
+    process* running;
+    int slice_left;
+    int continuing;
+    int seg_start;
+    int seg_end;
+    int seg_new;
+    int seg_done;
+    int runnable;
+    int has_open;
+    execute open;
+} cpu;
+
+// Everything a run allocates lives in its arena and goes away with sim_free.
+struct sim{
+    arena* a;
+    const policy* pol;
+    process* processes;
+    int n;
+    int next;
+    int now;
+    int nb_cpus;
+    cpu* cpus;
+    slice_sink* sink;
+    int failed;
+#ifdef SCHED_STATS
+    sched_stats* stats;
+#endif
+};
+
+typedef struct collector{
+    execute* result;
+    int count;
+    int capacity;
+} collector;
+
+static const policy* const policies[] = {
+    &fifo_policy,
+    &rr_policy,
+    &pp_policy,
+    &multilevel_policy,
+};
+
+const policy* find_policy(const char* name){
+    if (name == NULL) return NULL;
+
+    for (size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++){
+        if (strcmp(policies[i]->name, name) == 0)
+            return policies[i];
+    }
+    return NULL;
+}
+
+// New arrivals go to the CPU with the fewest runnable processes. Only the
+// ones the policy queued count towards it.
+static void admit(sim* s){
+    while (s->next < s->n && s->processes[s->next].arrival <= s->now){
+        cpu* target = &s->cpus[0];
+        for (int i = 1; i < s->nb_cpus; i++){
+            if (s->cpus[i].runnable < target->runnable)
+                target = &s->cpus[i];
+        }
+        int queued = s->pol->enqueue(target->st, &s->processes[s->next]);
+        if (queued < 0)
+            s->failed = 1;
+        else if (queued == 0)
+            target->runnable++;
+        s->next++;
+    }
+}
+
+static void close_slice(sim* s, cpu* c){
+    if (!c->has_open) return;
+
+    // Work only moves forward, so the process's cursor normally just advances;
+    // extraction costs O(total events) over the whole run.
+    execute* e = &c->open;
+    process* p = e->p;
+    int end = e->offset + (e->te - e->ts);
+    int k = p->next_event;
+    while (k > 0 && p->events[k - 1].t >= e->offset)
+        k--;
+    while (k < p->nbEvents && p->events[k].t < e->offset)
+        k++;
+    e->events = p->events + k;
+    while (k < p->nbEvents && p->events[k].t < end)
+        k++;
+    e->event_count = (int)(p->events + k - e->events);
+    p->next_event = k;
+
+    c->has_open = 0;
+    STATS_INC(slices);
+    STATS_ADD(events_extracted, e->event_count);
+    STATS_START(emit_start);
+    if (!s->failed && s->sink->emit(s->sink->ctx, e) != 0)
+        s->failed = 1;
+    STATS_TIME(emit_ns, emit_start);
+}
+
+// Starts a segment of the running process at s->now, extending the CPU's open slice
+// when the run continues it.
+static void start_segment(sim* s, cpu* c){
+    process* p = c->running;
+    int ran = min(p->rem_time, c->slice_left);
+    if (ran < 0) ran = 0;
+    if (s->pol->preemptive && s->next < s->n)
+        ran = min(ran, s->processes[s->next].arrival - s->now);
+    c->seg_start = s->now;
+    c->seg_end = s->now + ran;
+
+    execute* e = &c->open;
+    if (c->has_open && e->p == p && e->te == s->now && (c->continuing || s->pol->coalesce)){
+        e->te = c->seg_end;
+        c->seg_new = 0;
+        return;
+    }
+
+    close_slice(s, c);
+    if (e->p != p)
+        STATS_INC(context_switches);
+    e->p = p;
+    e->ts = s->now;
+    e->te = c->seg_end;
+    e->event_count = 0;
+    e->events = NULL;
+    e->offset = p->exec_time - p->rem_time;
+    e->cpu = (int)(c - s->cpus);
+    c->has_open = 1;
+    c->seg_new = 1;
+}
+
+// Takes a queued process from the CPU with the most waiting work.
+static process* steal_work(sim* s, cpu* thief){
+    if (s->pol->steal == NULL) return NULL;
+
+    cpu* victim = NULL;
+    int most = 0;
+    for (int i = 0; i < s->nb_cpus; i++){
+        cpu* c = &s->cpus[i];
+        int waiting = c->runnable - (c->running != NULL);
+        if (c != thief && waiting > most){
+            victim = c;
+            most = waiting;
+        }
+    }
+    if (victim == NULL) return NULL;
+
+    process* p = s->pol->steal(victim->st, thief->st, victim->running);
+    if (p == NULL) return NULL;
+    victim->runnable--;
+    thief->runnable++;
+    return s->pol->pick_next(thief->st);
+}
+
+static void dispatch(sim* s){
+    for (int i = 0; i < s->nb_cpus; i++){
+        cpu* c = &s->cpus[i];
+        if (c->running != NULL) continue;
+
+        process* p = s->pol->pick_next(c->st);
+        if (p == NULL && s->nb_cpus > 1)
+            p = steal_work(s, c);
+        if (p == NULL){
+            close_slice(s, c);
+            continue;
+        }
+        c->running = p;
+        c->slice_left = s->pol->time_slice ? s->pol->time_slice(c->st, p) : INT_MAX;
+        c->continuing = 0;
+        start_segment(s, c);
+    }
+}
+
+// Ends the segments finishing at s->now, admits new arrivals, then decides who
+// keeps each of those CPUs.
+static void end_segments(sim* s){
+    for (int i = 0; i < s->nb_cpus; i++){
+        cpu* c = &s->cpus[i];
+        c->seg_done = c->running != NULL && c->seg_end == s->now;
+        if (!c->seg_done) continue;
+
+        int ran = c->seg_end - c->seg_start;
+        c->running->rem_time -= ran;
+        c->slice_left -= ran;
+        if (s->pol->on_tick)
+            s->pol->on_tick(c->st, c->running, ran, c->seg_new);
+    }
+
+    admit(s);
+
+    for (int i = 0; i < s->nb_cpus; i++){
+        cpu* c = &s->cpus[i];
+        if (!c->seg_done) continue;
+
+        process* p = c->running;
+        int preempted = 0;
+        if (p->rem_time <= 0){
+            c->runnable--;
+            c->running = NULL;
+        }else if (s->pol->preempt && (preempted = s->pol->preempt(c->st, p, c->slice_left <= 0)) != 0){
+            if (preempted < 0) s->failed = 1;
+            c->running = NULL;
+        }else if (c->slice_left <= 0){
+            int queued = s->pol->enqueue(c->st, p);
+            if (queued < 0) s->failed = 1;
+            else if (queued > 0) c->runnable--;
+            c->running = NULL;
+        }else{
+            c->continuing = 1;
+            start_segment(s, c);
+        }
+    }
+}
+
+void sim_free(sim* s){
+    if (s == NULL) return;
+    free_arena(s->a);
+}
+
+sim* sim_create(const policy* pol, process* processes, int n, const sim_params* params){
+    if (pol == NULL || params == NULL || (processes == NULL && n > 0))
+        return NULL;
+
+    arena* a = create_arena(SIM_ARENA_BLOCK);
+    if (a == NULL) return NULL;
+    sim* s = (sim*)arena_calloc(a, 1, sizeof(sim));
+    if (s == NULL){
+        free_arena(a);
+        return NULL;
+    }
+    s->a = a;
+    s->pol = pol;
+    s->processes = processes;
+    s->n = n;
+    s->nb_cpus = params->cpus > 1 ? params->cpus : 1;
+
+    s->cpus = (cpu*)arena_calloc(a, s->nb_cpus, sizeof(cpu));
+    if (s->cpus == NULL){
+        sim_free(s);
+        return NULL;
+    }
+    for (int i = 0; i < s->nb_cpus; i++){
+        s->cpus[i].st = pol->create(params, a);
+        if (s->cpus[i].st == NULL){
+            sim_free(s);
+            return NULL;
+        }
+    }
+
+    STATS_START(sort_start);
+    for (int i = 0; i < n; i++)
+        sort_events(&processes[i]);
+    qsort(processes, n, sizeof(process), compare_process);
+    STATS_TIME(sort_ns, sort_start);
+#ifdef SCHED_STATS
+    s->stats = stats_current;
+#endif
+    return s;
+}
+
+// The run's stats are attached while it steps, whatever the caller has.
+#ifdef SCHED_STATS
+#define STATS_ENTER(s) sched_stats* outer_stats = stats_attach((s)->stats); STATS_START(step_start)
+#define STATS_LEAVE() STATS_TIME(run_ns, step_start); stats_attach(outer_stats)
+#else
+#define STATS_ENTER(s) ((void)0)
+#define STATS_LEAVE() ((void)0)
+#endif
+
+void sim_start(sim* s, slice_sink* sink){
+    STATS_ENTER(s);
+    s->sink = sink;
+    admit(s);
+    dispatch(s);
+    STATS_LEAVE();
+}
+
+// Advances the clock to the next segment end or arrival. Returns 1 while the
+// run goes on, then 0 (or -1 on failure) once the last slices are closed.
+static int step(sim* s){
+    int t = INT_MAX;
+    if (!s->failed){
+        for (int i = 0; i < s->nb_cpus; i++){
+            if (s->cpus[i].running != NULL)
+                t = min(t, s->cpus[i].seg_end);
+        }
+        if (s->next < s->n)
+            t = min(t, s->processes[s->next].arrival);
+    }
+
+    if (t != INT_MAX){
+        s->now = t;
+        end_segments(s);
+        dispatch(s);
+        return 1;
+    }
+
+    for (int i = 0; i < s->nb_cpus; i++)
+        close_slice(s, &s->cpus[i]);
+    return s->failed ? -1 : 0;
+}
+
+int sim_step(sim* s){
+    STATS_ENTER(s);
+    int status = step(s);
+    STATS_LEAVE();
+    return status;
+}
+
+int sim_run(sim* s, slice_sink* sink){
+    int status;
+    sim_start(s, sink);
+    while ((status = sim_step(s)) > 0)
+        ;
+    return status;
+}
+
+static int collect_slice(void* ctx, const execute* e){
+    collector* col = (collector*)ctx;
+    if (col->count == col->capacity){
+        int capacity = col->capacity * 2;
+        execute* result = (execute*)realloc(col->result, capacity * sizeof(execute));
+        if (result == NULL) return -1;
+        col->result = result;
+        col->capacity = capacity;
+    }
+
+    col->result[col->count++] = *e;
+    return 0;
+}
+
+execute* simulate(const policy* pol, process* processes, int n, const sim_params* params, int* out_cnt){
+    *out_cnt = 0;
+    sim* s = sim_create(pol, processes, n, params);
+    if (s == NULL) return NULL;
+
+    collector col = { .capacity = 16 };
+    col.result = (execute*)malloc(col.capacity * sizeof(execute));
+    slice_sink sink = { collect_slice, &col };
+    if (col.result == NULL || sim_run(s, &sink) != 0){
+        free(col.result);
+        sim_free(s);
+        return NULL;
+    }
+
+    sim_free(s);
+    *out_cnt = col.count;
+    return col.result;
+}
@@ -0,0 +1,214 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "../../Include/Generator.h"
+#include "../../Include/Intern.h"
+
+static const char* const comments[] = { "IO", "Stop", "Done", "Read", "Write", "Wait", "Signal", "Fork" };
+#define NB_COMMENTS (sizeof(comments) / sizeof(comments[0]))
+
+// splitmix64: one add and three multiply-xorshifts a draw, the same sequence
+// on every platform.
+typedef struct rng{
+    uint64_t state;
+} rng;
+
+static uint64_t next_u64(rng* r){
+    uint64_t z = (r->state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Uniform in (0, 1): never 0, so its log is finite.
+static double next_unit(rng* r){
+    return ((next_u64(r) >> 11) + 0.5) * 0x1.0p-53;
+}
+
+static uint64_t next_below(rng* r, uint64_t bound){
+    return (uint64_t)(((unsigned __int128)next_u64(r) * bound) >> 64);
+}
+
+static double exponential(rng* r, double mean){
+    return -mean * log(next_unit(r));
+}
+
+static double pareto(rng* r, double minimum, double shape){
+    return minimum * pow(next_unit(r), -1.0 / shape);
+}
+
+// Knuth's product of uniforms; the mean is capped, so exp() stays far from 0.
+static int poisson(rng* r, double limit){
+    int k = 0;
+    double product = next_unit(r);
+    while (product > limit){
+        k++;
+        product *= next_unit(r);
+    }
+    return k;
+}
+
+void gen_defaults(gen_params* params){
+    params->seed = 1;
+    params->nb_processes = 1000;
+    params->arrivals = ARRIVALS_POISSON;
+    params->rate = 0.1;
+    params->burst_rate = 2.0;
+    params->calm_length = 500.0;
+    params->burst_length = 50.0;
+    params->exec = EXEC_EXPONENTIAL;
+    params->exec_mean = 8.0;
+    params->exec_long = 100.0;
+    params->long_share = 0.1;
+    params->pareto_shape = 1.5;
+    params->max_exec = 100000;
+    params->min_priority = 0;
+    params->max_priority = 7;
+    params->events_mean = 1.0;
+}
+
+int gen_check(const gen_params* params, const char** error){
+    const char* reason = NULL;
+    if (params->nb_processes < 0)
+        reason = "process count must not be negative";
+    else if (!(params->rate > 0))
+        reason = "arrival rate must be positive";
+    else if (params->arrivals == ARRIVALS_BURSTY &&
+             (!(params->burst_rate > 0) || !(params->calm_length > 0) || !(params->burst_length > 0)))
+        reason = "burst rate and state lengths must be positive";
+    else if (!(params->exec_mean > 0) || params->max_exec < 1)
+        reason = "exec_time mean and maximum must be positive";
+    else if (params->exec == EXEC_PARETO && !(params->pareto_shape > 0))
+        reason = "Pareto shape must be positive";
+    else if (params->exec == EXEC_BIMODAL &&
+             (!(params->exec_long > 0) || !(params->long_share >= 0 && params->long_share <= 1)))
+        reason = "long mean must be positive and the long share within [0, 1]";
+    else if (params->min_priority > params->max_priority)
+        reason = "priority range is empty";
+    else if (!(params->events_mean >= 0 && params->events_mean <= GEN_MAX_EVENTS_MEAN))
+        reason = "events mean must be within [0, 64]";
+
+    if (reason != NULL){
+        if (error != NULL) *error = reason;
+        return -1;
+    }
+    return 0;
+}
+
+static int draw_exec(rng* r, const gen_params* params){
+    double x;
+    switch (params->exec){
+    case EXEC_PARETO:
+        x = pareto(r, params->exec_mean, params->pareto_shape);
+        break;
+    case EXEC_BIMODAL:
+        x = exponential(r, next_unit(r) < params->long_share ? params->exec_long : params->exec_mean);
+        break;
+    default:
+        x = exponential(r, params->exec_mean);
+        break;
+    }
+    if (!(x < params->max_exec)) return params->max_exec;
+    return x < 1 ? 1 : (int)ceil(x);
+}
+
+// Two-state MMPP. Both the next arrival and the end of the current state are
+// exponential, so whichever comes first is drawn afresh each time.
+typedef struct arrival_clock{
+    double now;
+    double state_left;
+    int bursting;
+} arrival_clock;
+
+static double next_arrival(rng* r, arrival_clock* c, const gen_params* params){
+    if (params->arrivals != ARRIVALS_BURSTY){
+        c->now += exponential(r, 1.0 / params->rate);
+        return c->now;
+    }
+    for (;;){
+        double gap = exponential(r, 1.0 / (c->bursting ? params->burst_rate : params->rate));
+        if (gap < c->state_left){
+            c->state_left -= gap;
+            c->now += gap;
+            return c->now;
+        }
+        c->now += c->state_left;
+        c->bursting = !c->bursting;
+        c->state_left = exponential(r, c->bursting ? params->burst_length : params->calm_length);
+    }
+}
+
+static void write_name(char* name, int pid){
+    char digits[12];
+    int len = 0;
+    do {
+        digits[len++] = '0' + pid % 10;
+        pid /= 10;
+    } while (pid > 0);
+    *name++ = 'P';
+    while (len > 0)
+        *name++ = digits[--len];
+    *name = '\0';
+}
+
+// Processes first, then events from a second stream: the event total sizes
+// the block, and a workload's processes do not depend on its event mean.
+process* gen_workload(const gen_params* params){
+    if (gen_check(params, NULL) != 0) return NULL;
+
+    int n = params->nb_processes;
+    process* processes = (process*)malloc(n > 0 ? n * sizeof(process) : 1);
+    if (processes == NULL) return NULL;
+
+    rng r = { params->seed };
+    arrival_clock clock = { 0.0, 0.0, 0 };
+    if (params->arrivals == ARRIVALS_BURSTY)
+        clock.state_left = exponential(&r, params->calm_length);
+    double limit = exp(-params->events_mean);
+    size_t nb_events = 0;
+    for (int i = 0; i < n; i++){
+        double t = next_arrival(&r, &clock, params);
+        if (t >= INT_MAX){
+            free(processes);
+            return NULL;
+        }
+        process* p = &processes[i];
+        memset(p, 0, sizeof(process));
+        p->pid = i + 1;
+        write_name(p->name, i + 1);
+        p->arrival = (int)t;
+        p->exec_time = draw_exec(&r, params);
+        p->rem_time = p->exec_time;
+        p->priority = params->min_priority +
+                      (int)next_below(&r, (uint64_t)((int64_t)params->max_priority - params->min_priority + 1));
+        int count = params->events_mean > 0 ? poisson(&r, limit) : 0;
+        p->nbEvents = count < p->exec_time ? count : p->exec_time;
+        nb_events += p->nbEvents;
+    }
+
+    size_t head = n * sizeof(process);
+    process* block = (process*)realloc(processes, head + nb_events * sizeof(event) + 1);
+    if (block == NULL){
+        free(processes);
+        return NULL;
+    }
+
+    uint32_t ids[NB_COMMENTS];
+    for (size_t i = 0; i < NB_COMMENTS; i++)
+        ids[i] = intern_comment(comments[i]);
+
+    rng er = { params->seed ^ 0x6a09e667f3bcc909ull };
+    event* pool = (event*)((char*)block + head);
+    for (int i = 0; i < n; i++){
+        process* p = &block[i];
+        p->events = p->nbEvents ? pool : NULL;
+        for (int j = 0; j < p->nbEvents; j++){
+            pool[j].t = (int)next_below(&er, p->exec_time);
+            pool[j].comment_id = ids[next_below(&er, NB_COMMENTS)];
+        }
+        pool += p->nbEvents;
+        sort_events(p);
+    }
+    return block;
+}
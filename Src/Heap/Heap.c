@@ -0,0 +1,129 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../../Include/Heap.h"
+#include "../../Include/Stats.h"
+
+static int entry_less(heap* h, heap_entry* a, heap_entry* b){
+    int c = h->cmp(a->data, b->data);
+    if (c != 0)
+        return c < 0;
+    return a->seq < b->seq;
+}
+
+static void sift_up(heap* h, int i){
+    heap_entry e = h->entries[i];
+    while (i > 0){
+        int parent = (i - 1) / 2;
+        if (!entry_less(h, &e, &h->entries[parent]))
+            break;
+        h->entries[i] = h->entries[parent];
+        i = parent;
+    }
+    h->entries[i] = e;
+}
+
+static void sift_down(heap* h, int i){
+    heap_entry e = h->entries[i];
+    while (1){
+        int child = 2 * i + 1;
+        if (child >= h->sz)
+            break;
+        if (child + 1 < h->sz && entry_less(h, &h->entries[child + 1], &h->entries[child]))
+            child++;
+        if (!entry_less(h, &h->entries[child], &e))
+            break;
+        h->entries[i] = h->entries[child];
+        i = child;
+    }
+    h->entries[i] = e;
+}
+
+static void init_heap(heap* h, arena* a, heap_cmp cmp){
+    h->sz = 0;
+    h->cap = 0;
+    h->seq = 0;
+    h->entries = NULL;
+    h->cmp = cmp;
+    h->a = a;
+}
+
+heap* create_heap(heap_cmp cmp){
+    heap* h = (heap*)malloc(sizeof(heap));
+    if (!h) return NULL;
+    init_heap(h, NULL, cmp);
+    return h;
+}
+
+heap* create_heap_in(arena* a, heap_cmp cmp){
+    heap* h = (heap*)arena_alloc(a, sizeof(heap));
+    if (!h) return NULL;
+    init_heap(h, a, cmp);
+    return h;
+}
+
+// Arena heaps cannot realloc: the entries move to a fresh array and the old one
+// is left to the arena, which bounds the waste to the final size.
+static heap_entry* grow_entries(heap* h, int cap){
+    if (h->a == NULL)
+        return (heap_entry*)realloc(h->entries, cap * sizeof(heap_entry));
+
+    heap_entry* entries = (heap_entry*)arena_alloc(h->a, cap * sizeof(heap_entry));
+    if (entries != NULL && h->sz > 0)
+        memcpy(entries, h->entries, h->sz * sizeof(heap_entry));
+    return entries;
+}
+
+int heap_push(heap* h, void* dataToPush){
+    if (h == NULL) return -1;
+
+    if (h->sz == h->cap){
+        int cap = h->cap ? h->cap * 2 : 16;
+        heap_entry* entries = grow_entries(h, cap);
+        if (!entries) return -1;
+        h->entries = entries;
+        h->cap = cap;
+    }
+
+    h->entries[h->sz].data = dataToPush;
+    h->entries[h->sz].seq = h->seq++;
+    h->sz++;
+    sift_up(h, h->sz - 1);
+    STATS_INC(queue_pushes);
+    return 0;
+}
+
+void heap_pop(heap* h){
+    if (h == NULL || h->sz == 0)
+        return;
+    STATS_INC(queue_pops);
+    h->sz--;
+    if (h->sz > 0){
+        h->entries[0] = h->entries[h->sz];
+        sift_down(h, 0);
+    }
+}
+
+void* heap_top(heap* h){
+    if (h == NULL || h->sz == 0)
+        return NULL;
+    return h->entries[0].data;
+}
+
+// Removes the last leaf: O(1), never the top unless it is the only entry.
+void* heap_take_last(heap* h){
+    if (h == NULL || h->sz == 0)
+        return NULL;
+    STATS_INC(queue_pops);
+    h->sz--;
+    return h->entries[h->sz].data;
+}
+
+int heap_size(heap* h){
+    return h->sz;
+}
+
+void free_heap(heap* h){
+    if (h == NULL || h->a != NULL) return;
+    free(h->entries);
+    free(h);
+}
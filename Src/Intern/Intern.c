@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../../Include/Intern.h"
+#include "../../Include/Arena.h"
+
+#define CHUNK_BITS 12
+#define CHUNK_SIZE (1u << CHUNK_BITS)
+#define MAX_CHUNKS (1u << 14)
+#define TEXT_BLOCK (64 * 1024)
+#define TABLE_TEXT_BLOCK 4096
+
+// Texts are reached through fixed-size chunks that never move once published,
+// so readers need no lock. The hash index is only touched by the writer.
+// The process-wide table has a fixed directory for the same reason; private
+// tables grow theirs, having a single thread.
+struct comment_table{
+    const char*** chunks;
+    uint32_t nb_chunks;
+    uint32_t count;
+    uint32_t* slots;
+    uint32_t nb_slots;
+    arena* texts;
+};
+
+static const char** global_chunks[MAX_CHUNKS];
+static comment_table global = { global_chunks, MAX_CHUNKS, 0, NULL, 0, NULL };
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t hash_text(const char* s, size_t len){
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ (unsigned char)s[i]) * 16777619u;
+    return h;
+}
+
+static int same_text(const char* stored, const char* s, size_t len){
+    return strncmp(stored, s, len) == 0 && stored[len] == '\0';
+}
+
+static const char* text_of(const comment_table* t, uint32_t id){
+    uint32_t chunk = id >> CHUNK_BITS;
+    if (chunk >= t->nb_chunks || t->chunks[chunk] == NULL || t->chunks[chunk][id & (CHUNK_SIZE - 1)] == NULL)
+        return "";
+    return t->chunks[chunk][id & (CHUNK_SIZE - 1)];
+}
+
+// Slots hold id + 1 so that 0 marks an empty slot.
+static uint32_t* find_slot(const comment_table* t, uint32_t* table, uint32_t size, const char* s, size_t len, uint32_t h){
+    uint32_t i = h & (size - 1);
+    while (table[i] != 0 && !same_text(text_of(t, table[i] - 1), s, len))
+        i = (i + 1) & (size - 1);
+    return &table[i];
+}
+
+static int grow_slots(comment_table* t){
+    uint32_t size = t->nb_slots ? t->nb_slots * 2 : 1024;
+    uint32_t* table = (uint32_t*)calloc(size, sizeof(uint32_t));
+    if (table == NULL) return -1;
+
+    for (uint32_t i = 0; i < t->nb_slots; i++){
+        if (t->slots[i] == 0) continue;
+        const char* s = text_of(t, t->slots[i] - 1);
+        size_t len = strlen(s);
+        *find_slot(t, table, size, s, len, hash_text(s, len)) = t->slots[i];
+    }
+    free(t->slots);
+    t->slots = table;
+    t->nb_slots = size;
+    return 0;
+}
+
+static int add_text(comment_table* t, const char* s, size_t len){
+    uint32_t chunk = t->count >> CHUNK_BITS;
+    if (chunk >= MAX_CHUNKS) return -1;
+    if (chunk >= t->nb_chunks){
+        uint32_t n = t->nb_chunks ? t->nb_chunks * 2 : 1;
+        const char*** chunks = (const char***)realloc(t->chunks, n * sizeof(const char**));
+        if (chunks == NULL) return -1;
+        memset(chunks + t->nb_chunks, 0, (n - t->nb_chunks) * sizeof(const char**));
+        t->chunks = chunks;
+        t->nb_chunks = n;
+    }
+    if (t->chunks[chunk] == NULL){
+        t->chunks[chunk] = (const char**)calloc(CHUNK_SIZE, sizeof(char*));
+        if (t->chunks[chunk] == NULL) return -1;
+    }
+
+    char* copy = (char*)arena_alloc(t->texts, len + 1);
+    if (copy == NULL) return -1;
+    memcpy(copy, s, len);
+    copy[len] = '\0';
+    t->chunks[chunk][t->count & (CHUNK_SIZE - 1)] = copy;
+    return 0;
+}
+
+static uint32_t intern_in(comment_table* t, const char* text, size_t len, size_t block){
+    if (text == NULL){
+        text = "";
+        len = 0;
+    }
+
+    // Id 0 is the empty string, which is also what a failed intern returns.
+    if (t->texts == NULL && (t->texts = create_arena(block)) != NULL &&
+        grow_slots(t) == 0 && add_text(t, "", 0) == 0){
+        *find_slot(t, t->slots, t->nb_slots, "", 0, hash_text("", 0)) = 1;
+        t->count = 1;
+    }
+    // Keep the index at most half full.
+    if (t->count == 0 || ((t->count + 1) * 2 > t->nb_slots && grow_slots(t) != 0))
+        return 0;
+
+    uint32_t* slot = find_slot(t, t->slots, t->nb_slots, text, len, hash_text(text, len));
+    if (*slot != 0)
+        return *slot - 1;
+    if (add_text(t, text, len) != 0)
+        return 0;
+    *slot = t->count + 1;
+    return t->count++;
+}
+
+uint32_t intern_comment(const char* text){
+    return intern_comment_len(text, text ? strlen(text) : 0);
+}
+
+uint32_t intern_comment_len(const char* text, size_t len){
+    pthread_mutex_lock(&lock);
+    uint32_t id = intern_in(&global, text, len, TEXT_BLOCK);
+    pthread_mutex_unlock(&lock);
+    return id;
+}
+
+const char* comment_text(uint32_t id){
+    return text_of(&global, id);
+}
+
+uint32_t interned_count(void){
+    pthread_mutex_lock(&lock);
+    uint32_t n = global.count;
+    pthread_mutex_unlock(&lock);
+    return n;
+}
+
+comment_table* create_comment_table(void){
+    return (comment_table*)calloc(1, sizeof(comment_table));
+}
+
+uint32_t comment_table_intern(comment_table* t, const char* text, size_t len){
+    return intern_in(t, text, len, TABLE_TEXT_BLOCK);
+}
+
+const char* comment_table_text(const comment_table* t, uint32_t id){
+    return t ? text_of(t, id) : comment_text(id);
+}
+
+uint32_t comment_table_count(const comment_table* t){
+    return t ? t->count : interned_count();
+}
+
+void free_comment_table(comment_table* t){
+    if (t == NULL) return;
+    for (uint32_t i = 0; i < t->nb_chunks; i++)
+        free(t->chunks[i]);
+    free(t->chunks);
+    free(t->slots);
+    free_arena(t->texts);
+    free(t);
+}
@@ -3,16 +3,49 @@
 
 list* create_list(){
     list* l = (list*)malloc(sizeof(list));
+    if (!l) return NULL;
     l->sz = 0;
     l->head = l->tail = NULL;
+    l->a = NULL;
+    l->spare = NULL;
     return l;
 }
 
-void add_head(list *l, void *dataToAdd){
-    if (l == NULL) return;
+list* create_list_in(arena* a){
+    list* l = (list*)arena_alloc(a, sizeof(list));
+    if (!l) return NULL;
+    l->sz = 0;
+    l->head = l->tail = NULL;
+    l->a = a;
+    l->spare = NULL;
+    return l;
+}
 
-    node* nw = (node*)malloc(sizeof(node));
-    if (!nw) return;
+static node* new_node(list *l){
+    if (l->spare != NULL){
+        node* nw = l->spare;
+        l->spare = nw->suiv;
+        return nw;
+    }
+    if (l->a != NULL)
+        return (node*)arena_alloc(l->a, sizeof(node));
+    return (node*)malloc(sizeof(node));
+}
+
+static void release_node(list *l, node* old){
+    if (l->a != NULL){
+        old->suiv = l->spare;
+        l->spare = old;
+    }else {
+        free(old);
+    }
+}
+
+int add_head(list *l, void *dataToAdd){
+    if (l == NULL) return -1;
+
+    node* nw = new_node(l);
+    if (!nw) return -1;
 
     nw->data = dataToAdd;
     nw->prev = NULL;
@@ -25,13 +58,14 @@ void add_head(list *l, void *dataToAdd){
         l->head = nw;
     }
     l->sz++;
+    return 0;
 }
 
-void add_tail(list *l, void *dataToAdd) {
-    if (l == NULL) return;
+int add_tail(list *l, void *dataToAdd) {
+    if (l == NULL) return -1;
 
-    node* nw = (node*)malloc(sizeof(node));
-    if (!nw) return;
+    node* nw = new_node(l);
+    if (!nw) return -1;
 
     nw->data = dataToAdd;
     nw->suiv = NULL;
@@ -44,29 +78,34 @@ void add_tail(list *l, void *dataToAdd) {
         l->tail = nw;
     }
     l->sz++;
+    return 0;
 }
 
 void del_head(list *l){
     if (l == NULL || l->sz == 0) 
         return;
+    node* old = l->head;
     if (l->sz == 1){
         l->head = l->tail = NULL;
     }else {
         l->head = l->head->suiv;
         l->head->prev = NULL;
     }
+    release_node(l, old);
     l->sz--;
 }
 
 void del_tail(list *l){
     if (l == NULL || l->sz == 0) 
         return;
+    node* old = l->tail;
     if (l->sz == 1){
         l->head = l->tail = NULL;
     }else {
         l->tail = l->tail->prev;
         l->tail->suiv = NULL;
     }
+    release_node(l, old);
     l->sz--;
 }
 
@@ -85,4 +124,15 @@ void* get_tail(list* l) {
 
 int getsz(list *l){
     return l->sz;
+}
+
+void free_list(list *l){
+    if (l == NULL || l->a != NULL) return;
+    node* curr = l->head;
+    while (curr != NULL){
+        node* nxt = curr->suiv;
+        free(curr);
+        curr = nxt;
+    }
+    free(l);
 }
\ No newline at end of file
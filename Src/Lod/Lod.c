@@ -0,0 +1,217 @@
+#include <stdlib.h>
+#include "../../Include/Lod.h"
+
+// Finer than this a client is better off reading the slices themselves.
+#define SLICES_PER_BUCKET 4
+
+typedef struct share{
+    int pid;
+    long long busy;
+} share;
+
+typedef struct share_list{
+    share* items;
+    int n;
+    int cap;
+} share_list;
+
+static int add_share(share_list* l, int pid, long long busy){
+    // Back-to-back shares of one process merge here, the rest in settle.
+    if (l->n > 0 && l->items[l->n - 1].pid == pid){
+        l->items[l->n - 1].busy += busy;
+        return 0;
+    }
+    if (l->n == l->cap){
+        int cap = l->cap ? l->cap * 2 : 16;
+        share* items = (share*)realloc(l->items, cap * sizeof(share));
+        if (items == NULL) return -1;
+        l->items = items;
+        l->cap = cap;
+    }
+    l->items[l->n++] = (share){ pid, busy };
+    return 0;
+}
+
+static int by_pid(const void* a, const void* b){
+    int x = ((const share*)a)->pid, y = ((const share*)b)->pid;
+    return (x > y) - (x < y);
+}
+
+// Puts pid in the bucket's list if it ran longer than one there, the smaller
+// pid first on a tie.
+static void offer(lod_bucket* b, int pid, long long busy){
+    int i = LOD_TOP;
+    while (i > 0 && (b->top[i - 1].pid == 0 || busy > b->top[i - 1].busy ||
+                     (busy == b->top[i - 1].busy && pid < b->top[i - 1].pid)))
+        i--;
+    if (i == LOD_TOP) return;
+    for (int j = LOD_TOP - 1; j > i; j--)
+        b->top[j] = b->top[j - 1];
+    b->top[i] = (lod_share){ pid, (int)busy };
+}
+
+// Fills the bucket's list from its shares and empties them.
+static void settle(lod_bucket* b, share_list* l){
+    if (l->n > 1)
+        qsort(l->items, l->n, sizeof(share), by_pid);
+    for (int i = 0; i < l->n; ){
+        int pid = l->items[i].pid;
+        long long busy = 0;
+        for (; i < l->n && l->items[i].pid == pid; i++)
+            busy += l->items[i].busy;
+        offer(b, pid, busy);
+    }
+    l->n = 0;
+}
+
+static int fill_base(const lod_pyramid* p, const trace_lane* lane, lod_bucket* buckets, share_list* shares){
+    long long width = 1LL << p->base_shift;
+    int last = p->level_size[0] - 1;
+    int current = -1;
+
+    for (int i = 0; i < lane->n; i++){
+        const trace_slice* s = &lane->slices[i];
+        long long ts = s->ts - (long long)p->origin, te = s->te - (long long)p->origin;
+        buckets[ts >> p->base_shift < last ? ts >> p->base_shift : last].slices++;
+        for (long long b = ts >> p->base_shift; b <= last && b * width < te; b++){
+            long long lo = b * width > ts ? b * width : ts;
+            long long hi = (b + 1) * width < te ? (b + 1) * width : te;
+            if (b != current){
+                if (current >= 0) settle(&buckets[current], shares);
+                current = (int)b;
+            }
+            buckets[b].busy += hi - lo;
+            if (add_share(shares, s->pid, hi - lo) != 0) return -1;
+        }
+    }
+    if (current >= 0) settle(&buckets[current], shares);
+
+    for (int i = 0; i < lane->nb_events; i++){
+        long long b = (lane->events[i] - (long long)p->origin) >> p->base_shift;
+        buckets[b < 0 ? 0 : b > last ? last : b].events++;
+    }
+    return 0;
+}
+
+static const lod_bucket idle = { 0, 0, 0, { { 0, 0 } } };
+
+static long long share_of(const lod_bucket* b, int pid){
+    for (int i = 0; i < LOD_TOP && b->top[i].pid != 0; i++){
+        if (b->top[i].pid == pid) return b->top[i].busy;
+    }
+    return 0;
+}
+
+// A process's time is summed over the halves whose lists kept it.
+static lod_bucket merge(const lod_bucket* a, const lod_bucket* b){
+    lod_bucket m = { a->busy + b->busy, a->slices + b->slices, a->events + b->events, { { 0, 0 } } };
+    for (int i = 0; i < LOD_TOP && a->top[i].pid != 0; i++)
+        offer(&m, a->top[i].pid, a->top[i].busy + share_of(b, a->top[i].pid));
+    for (int i = 0; i < LOD_TOP && b->top[i].pid != 0; i++){
+        if (share_of(a, b->top[i].pid) == 0)
+            offer(&m, b->top[i].pid, b->top[i].busy);
+    }
+    return m;
+}
+
+lod_pyramid* lod_build(const trace* t){
+    lod_pyramid* p = (lod_pyramid*)calloc(1, sizeof(lod_pyramid));
+    if (p == NULL) return NULL;
+    p->nb_cpus = t->nb_cpus;
+    p->origin = t->start;
+
+    long long span = (long long)t->end - t->start;
+    long long per_lane = t->n / t->nb_cpus / SLICES_PER_BUCKET;
+    if (span < 1) span = 1;
+    if (per_lane < 1) per_lane = 1;
+    while (((span - 1) >> p->base_shift) + 1 > per_lane)
+        p->base_shift++;
+
+    int size = (int)(((span - 1) >> p->base_shift) + 1);
+    for (int s = size; ; s = (s + 1) / 2){
+        p->nb_levels++;
+        if (s == 1) break;
+    }
+    p->level_size = (int*)malloc(p->nb_levels * sizeof(int));
+    p->level_offset = (int*)malloc(p->nb_levels * sizeof(int));
+    p->lanes = (lod_bucket**)calloc(t->nb_cpus, sizeof(lod_bucket*));
+    if (p->level_size == NULL || p->level_offset == NULL || p->lanes == NULL){
+        lod_free(p);
+        return NULL;
+    }
+    int total = 0;
+    for (int l = 0; l < p->nb_levels; l++){
+        p->level_size[l] = size;
+        p->level_offset[l] = total;
+        total += size;
+        size = (size + 1) / 2;
+    }
+
+    share_list shares = { NULL, 0, 0 };
+    for (int c = 0; c < t->nb_cpus; c++){
+        lod_bucket* buckets = (lod_bucket*)calloc(total, sizeof(lod_bucket));
+        p->lanes[c] = buckets;
+        if (buckets == NULL || fill_base(p, &t->lanes[c], buckets, &shares) != 0){
+            free(shares.items);
+            lod_free(p);
+            return NULL;
+        }
+        for (int l = 1; l < p->nb_levels; l++){
+            const lod_bucket* below = buckets + p->level_offset[l - 1];
+            lod_bucket* level = buckets + p->level_offset[l];
+            for (int i = 0; i < p->level_size[l]; i++){
+                int right = 2 * i + 1 < p->level_size[l - 1];
+                level[i] = merge(&below[2 * i], right ? &below[2 * i + 1] : &idle);
+            }
+        }
+    }
+    free(shares.items);
+    return p;
+}
+
+int lod_level(const lod_pyramid* p, int from, int to, int pixels, int* first, int* last){
+    int level = 0;
+    for (; level < p->nb_levels; level++){
+        int shift = p->base_shift + level;
+        long long lo = from > p->origin ? (long long)from - p->origin : 0;
+        long long hi = (long long)to - p->origin - 1;
+        *first = (int)(lo >> shift < p->level_size[level] ? lo >> shift : p->level_size[level]);
+        *last = hi < 0 ? -1 : (int)(hi >> shift < p->level_size[level] ? hi >> shift : p->level_size[level] - 1);
+        if (*last - *first + 1 <= pixels || level == p->nb_levels - 1)
+            break;
+    }
+    return level;
+}
+
+long long lod_width(const lod_pyramid* p, int level){
+    return 1LL << (p->base_shift + level);
+}
+
+const lod_bucket* lod_buckets(const lod_pyramid* p, int cpu, int level){
+    return p->lanes[cpu] + p->level_offset[level];
+}
+
+void lod_write_json(FILE* out, const lod_bucket* b, long long t){
+    fprintf(out, "{\"t\":%lld,\"busy\":%lld,\"top\":[", t, b->busy);
+    for (int k = 0; k < LOD_TOP && b->top[k].pid != 0; k++)
+        fprintf(out, "%s{\"pid\":%d,\"busy\":%d}", k > 0 ? "," : "", b->top[k].pid, b->top[k].busy);
+    fprintf(out, "],\"slices\":%d,\"events\":%d}", b->slices, b->events);
+}
+
+size_t lod_bytes(const lod_pyramid* p){
+    int total = p->level_offset[p->nb_levels - 1] + p->level_size[p->nb_levels - 1];
+    return sizeof(lod_pyramid) + 2 * p->nb_levels * sizeof(int) +
+           p->nb_cpus * (sizeof(lod_bucket*) + (size_t)total * sizeof(lod_bucket));
+}
+
+void lod_free(lod_pyramid* p){
+    if (p == NULL) return;
+    if (p->lanes != NULL){
+        for (int c = 0; c < p->nb_cpus; c++)
+            free(p->lanes[c]);
+    }
+    free(p->lanes);
+    free(p->level_size);
+    free(p->level_offset);
+    free(p);
+}
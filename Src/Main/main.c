@@ -7,6 +7,7 @@
 #include "../../Include/Utils.h"
 #include "../../Include/Parser.h"
 #include "../../Include/Scheduler.h"
+#include "../../Include/Intern.h"
 #include "../../Include/SchedulersGetter.h"
 
 int main(int argc, char *argv[]) {
@@ -20,9 +21,13 @@ int main(int argc, char *argv[]) {
     } 
     char* schedulersFolder = strcat(cwd, "/Schedulers");
     FILE *f = fopen(argv[1], "r");
-    process* processes = (process*)malloc(sizeof(process) * 100);
+    if (!f) {
+        fprintf(stderr, "Cannot open config file: %s\n", argv[1]);
+        return 1;
+    }
+    process* processes = NULL;
     int nbProc = 0;
-    if (parser(f, processes, &nbProc) != 0) {
+    if (parser(f, &processes, &nbProc) != 0) {
         fprintf(stderr, "Failed to load processes from config file\n");
         return 1;
     }
@@ -89,7 +94,7 @@ int main(int argc, char *argv[]) {
         printf("Process: %s | From: %d To: %d \n", result[i].p->name, result[i].ts, result[i].te);
         printf("number of events is %d :\n", result[i].event_count);
         for (int j = 0; j < result[i].event_count; j++)
-            printf("%d %s\n",result[i].events[j].t, result[i].events[j].comment);
+            printf("%d %s\n",event_time(&result[i], &result[i].events[j]), comment_text(result[i].events[j].comment_id));
         printf("\n");
         sleep(1);
     }
@@ -3,134 +3,157 @@
 #include <string.h>
 #include <ctype.h>
 #include "../../Include/Utils.h"
-#include "../../Include/Parser.h"
+#include "../../Include/Workload.h"
 #include "../../Include/Scheduler.h"
+#include "../../Include/JsonOutput.h"
+#include "../../Include/ColumnOutput.h"
+#include "../../Include/Stats.h"
 
 int main(int argc, char *argv[]) {
-    if (argc < 3) {
-        fprintf(stderr, "Usage: %s <config_file> <algorithm> [quantum] [cpu_limit] [nb_priority]\n", argv[0]);
+    char* args[5];
+    int nb_args = 0;
+    int nb_cpus = 1;
+    int compact = 0;
+    int binary = 0;
+    int stats = 0;
+    int metrics = 0;
+    const char* detail = "full";
+    int sample_every = 0;
+    int sample_size = 0;
+    unsigned long long seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+            nb_cpus = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            compact = 1;
+        } else if (strcmp(argv[i], "--binary") == 0) {
+            binary = 1;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = 1;
+        } else if (strcmp(argv[i], "--metrics") == 0) {
+            metrics = 1;
+        } else if (strcmp(argv[i], "--detail") == 0 && i + 1 < argc) {
+            detail = argv[++i];
+        } else if (strcmp(argv[i], "--sample-every") == 0 && i + 1 < argc) {
+            sample_every = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--sample-size") == 0 && i + 1 < argc) {
+            sample_size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 0);
+        } else if (nb_args < 5) {
+            args[nb_args++] = argv[i];
+        }
+    }
+
+    if (nb_args < 2 || nb_cpus < 1 || nb_cpus > MAX_CPUS || (nb_args >= 5 && atoi(args[4]) > MAX_PRIORITY)) {
+        fprintf(stderr, "Usage: %s <config_file> <algorithm> [quantum] [cpu_limit] [nb_priority] [--cpus N] [--compact | --binary] [--stats] [--metrics]\n", argv[0]);
+        fprintf(stderr, "       [--detail full|summary|sampled] [--sample-every K | --sample-size N [--seed S]]\n");
         fprintf(stderr, "\nExamples:\n");
         fprintf(stderr, "  %s config.txt Fifo\n", argv[0]);
         fprintf(stderr, "  %s config.txt RoundRobin 2\n", argv[0]);
         fprintf(stderr, "  %s config.txt Multilevel 2 3 20\n", argv[0]);
+        fprintf(stderr, "  %s config.txt RoundRobin 2 --cpus 4\n", argv[0]);
+        fprintf(stderr, "  %s config.txt RoundRobin 2 --compact\n", argv[0]);
+        fprintf(stderr, "  %s config.txt RoundRobin 2 --binary > schedule.bin\n", argv[0]);
+        fprintf(stderr, "  %s config.txt RoundRobin 2 --metrics\n", argv[0]);
+        fprintf(stderr, "  %s config.txt RoundRobin 2 --detail sampled --sample-size 1000\n", argv[0]);
         return 1;
     }
-    FILE *f = fopen(argv[1], "r");
-    if (!f) {
-        fprintf(stderr, "Error: Cannot open config file: %s\n", argv[1]);
+    
+    // Summary is the metrics alone, so it turns them on.
+    int summary = strcmp(detail, "summary") == 0;
+    int sampled = strcmp(detail, "sampled") == 0;
+    if (!summary && !sampled && strcmp(detail, "full") != 0) {
+        fprintf(stderr, "Error: Unknown detail level: %s (full, summary or sampled)\n", detail);
         return 1;
     }
-    
-    process* processes = (process*)malloc(sizeof(process) * 100);
-    if (!processes) {
-        fprintf(stderr, "Error: Memory allocation failed\n");
-        fclose(f);
+    if (summary) metrics = 1;
+    if ((metrics || sampled) && binary) {
+        fprintf(stderr, "Error: --metrics and --detail are only available with the JSON output\n");
         return 1;
     }
+    if (stats && !STATS_ENABLED) {
+        fprintf(stderr, "Error: --stats needs a build with instrumentation (make clean && make STATS=1)\n");
+        return 1;
+    }
+    
+    // Everything below counts into run_stats; the summary goes to stderr.
+    sched_stats run_stats = {0};
+    if (stats) stats_attach(&run_stats);
     
-    int nbProc = 0;
-    if (parser(f, processes, &nbProc) != 0) {
-        fprintf(stderr, "Error: Failed to load processes from config file\n");
-        fclose(f);
-        free(processes);
+    // Text configs and binary workloads are both accepted.
+    uint64_t parse_start = stats ? stats_now() : 0;
+    workload* w = workload_open(args[0]);
+    if (stats) run_stats.parse_ns = stats_now() - parse_start;
+    if (!w) {
+        fprintf(stderr, "Error: Failed to load processes from config file: %s\n", args[0]);
         return 1;
     }
-    fclose(f);
+    process* processes = w->processes;
+    int nbProc = w->n;
     
-    char* choice = argv[2];  
-    int quantum = (argc >= 4) ? atoi(argv[3]) : 2;
-    int cpu_usage_limit = (argc >= 5) ? atoi(argv[4]) : 3;
-    int nbPriority = (argc >= 6) ? atoi(argv[5]) : 20;
-    execute* result = NULL;
-    int out_cnt = 0;
+    char* choice = args[1];  
+    sim_params params = {
+        .quantum = (nb_args >= 3) ? atoi(args[2]) : 2,
+        .cpu_usage_limit = (nb_args >= 4) ? atoi(args[3]) : 3,
+        .nb_priority = (nb_args >= 5) ? atoi(args[4]) : 20,
+        .cpus = nb_cpus,
+    };
     char* algo_name = choice;
     
-    if (strcmp(choice, "Fifo") == 0) {
-        result = fifo_scheduler(processes, nbProc, &out_cnt);
-    }
-    else if (strcmp(choice, "RoundRobin") == 0) {
-        result = rr_scheduler(processes, nbProc, quantum, &out_cnt);
-    }
-    else if (strcmp(choice, "PreemptivePriority") == 0) {
-        result = pp_scheduler(processes, nbProc, &out_cnt);
-    }
-    else if (strcmp(choice, "Multilevel") == 0) {
-        result = multilevel_scheduler(processes, nbProc, nbPriority, &out_cnt, cpu_usage_limit);
-    }
-    else {
+    const policy* pol = find_policy(choice);
+    if (!pol) {
         fprintf(stderr, "Error: Unknown algorithm: %s\n", choice);
         fprintf(stderr, "Available: Fifo, RoundRobin, PreemptivePriority, Multilevel\n");
-        free(processes);
+        workload_close(w);
         return 1;
     }
     
-    if (!result) {
+    sim* run = sim_create(pol, processes, nbProc, &params);
+    if (!run) {
         fprintf(stderr, "Error: Scheduler returned null\n");
-        free(processes);
+        workload_close(w);
         return 1;
     }
-  
-    printf("{\n");
-    printf("  \"success\": true,\n");
-    printf("  \"algorithm\": \"%s\",\n", algo_name);
-    printf("  \"totalProcesses\": %d,\n", nbProc);
-    printf("  \"executes\": [\n");
-    
-    for (int i = 0; i < out_cnt; i++) {
-        printf("    {\n");
-        
     
-        printf("      \"p\": {\n");
-        printf("        \"pid\": %d,\n", result[i].p->pid);
-        printf("        \"ppid\": %d,\n", result[i].p->ppid);
-        printf("        \"name\": \"%s\",\n", result[i].p->name);
-        printf("        \"arrival\": %d,\n", result[i].p->arrival);
-        printf("        \"exec_time\": %d,\n", result[i].p->exec_time);
-        printf("        \"rem_time\": %d,\n", result[i].p->rem_time);
-        printf("        \"cpu_usage\": %d,\n", result[i].p->cpu_usage);
-        printf("        \"priority\": %d,\n", result[i].p->priority);
-        printf("        \"nbEvents\": %d,\n", result[i].p->nbEvents);
-        
-        printf("        \"events\": [\n");
-        for (int j = 0; j < result[i].p->nbEvents; j++) {
-            printf("          {\n");
-            printf("            \"t\": %d,\n", result[i].p->events[j].t);
-            printf("            \"comment\": \"%s\"\n", result[i].p->events[j].comment);
-            printf("          }");
-            if (j < result[i].p->nbEvents - 1) printf(",");
-            printf("\n");
-        }
-        printf("        ]\n");
-        printf("      },\n");
-        
-       
-        printf("      \"ts\": %d,\n", result[i].ts);
-        printf("      \"te\": %d,\n", result[i].te);
-        
-        printf("      \"event_count\": %d,\n", result[i].event_count);
-        
-       
-        printf("      \"events\": [\n");
-        for (int j = 0; j < result[i].event_count; j++) {
-            printf("        {\n");
-            printf("          \"t\": %d,\n", result[i].events[j].t);
-            printf("          \"comment\": \"%s\"\n", result[i].events[j].comment);
-            printf("        }");
-            if (j < result[i].event_count - 1) printf(",");
-            printf("\n");
-        }
-        printf("      ]\n");
-        
-        printf("    }");
-        if (i < out_cnt - 1) printf(",");
-        printf("\n");
+    void* writer;
+    if (binary)
+        writer = columns_writer_create(stdout, algo_name, processes, nbProc, nb_cpus);
+    else if (compact)
+        writer = json_writer_create_compact(stdout, algo_name, processes, nbProc, nb_cpus);
+    else
+        writer = json_writer_create(stdout, algo_name, nbProc, nb_cpus);
+    if (!writer) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        sim_free(run);
+        workload_close(w);
+        return 1;
     }
     
-    printf("  ]\n");
-    printf("}\n");
+    if (stats && !binary) json_writer_set_stats(writer, &run_stats);
+    if (summary) json_writer_set_summary(writer);
+    if ((metrics && json_writer_enable_metrics(writer, processes, nbProc) != 0) ||
+        (sampled && json_writer_set_sampling(writer, sample_every, sample_size, seed) != 0)) {
+        fprintf(stderr, "Error: Memory allocation failed\n");
+        json_writer_finish(writer);
+        sim_free(run);
+        workload_close(w);
+        return 1;
+    }
     
+    slice_sink sink = { binary ? columns_write_execute : json_write_execute, writer };
+    int status = sim_run(run, &sink);
+    uint64_t finish_start = stats && binary ? stats_now() : 0;
+    if ((binary ? columns_writer_finish(writer) : json_writer_finish(writer)) != 0) status = -1;
+    if (stats && binary) run_stats.finish_ns = stats_now() - finish_start;
+    if (stats) stats_print(stderr, &run_stats);
     
-    free(processes);
+    sim_free(run);
+    workload_close(w);
     
+    if (status != 0) {
+        fprintf(stderr, "Error: Failed to write the schedule\n");
+        return 1;
+    }
     return 0;
 }
\ No newline at end of file
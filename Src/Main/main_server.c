@@ -1,16 +1,88 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "../../Include/HttpServer.h"
 
+#define DEFAULT_CACHE_MB 64
+#define DEFAULT_HTTP_THREADS 4
+#define DEFAULT_JOB_WORKERS 2
+#define DEFAULT_JOB_QUEUE 64
+#define DEFAULT_RUN_STORE_MB 256
+#define DEFAULT_COMPRESS_LEVEL 6
+#define DEFAULT_COMPRESS_MIN 1024
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s --server [--cache-mb N] [--http-threads N] [--job-workers N] [--job-queue N]\n"
+            "       [--run-store-mb N] [--compress-level N] [--compress-min N]\n", prog);
+    fprintf(stderr, "\nThis program starts an HTTP server on port 8080\n");
+    fprintf(stderr, "that receives scheduling requests from a web frontend.\n");
+    fprintf(stderr, "\n  --cache-mb N       memory for cached /api/schedule responses (default %d, 0 disables)\n",
+            DEFAULT_CACHE_MB);
+    fprintf(stderr, "  --http-threads N   threads answering HTTP requests (default %d)\n", DEFAULT_HTTP_THREADS);
+    fprintf(stderr, "  --job-workers N    threads running /api/jobs simulations (default %d)\n", DEFAULT_JOB_WORKERS);
+    fprintf(stderr, "  --job-queue N      jobs allowed to wait for a worker (default %d)\n", DEFAULT_JOB_QUEUE);
+    fprintf(stderr, "  --run-store-mb N   memory for finished jobs' slices served by /api/runs (default %d, 0 disables)\n",
+            DEFAULT_RUN_STORE_MB);
+    fprintf(stderr, "  --compress-level N gzip/deflate level 1-9 for clients that accept it (default %d, 0 disables)\n",
+            DEFAULT_COMPRESS_LEVEL);
+    fprintf(stderr, "  --compress-min N   smallest response body in bytes worth compressing (default %d)\n",
+            DEFAULT_COMPRESS_MIN);
+}
+
+// Non-negative integer option value, -1 when malformed.
+static long parse_count(const char *arg) {
+    char *end;
+    long value = strtol(arg, &end, 10);
+    return (*end != '\0' || end == arg || value < 0) ? -1 : value;
+}
+
 int main(int argc, char *argv[]) {
-   
-    if (argc != 2 || strcmp(argv[1], "--server") != 0) {
-        fprintf(stderr, "Usage: %s --server\n", argv[0]);
-        fprintf(stderr, "\nThis program starts an HTTP server on port 8080\n");
-        fprintf(stderr, "that receives scheduling requests from a web frontend.\n");
+    ServerOptions options = {
+        (size_t)DEFAULT_CACHE_MB * 1024 * 1024,
+        DEFAULT_HTTP_THREADS,
+        DEFAULT_JOB_WORKERS,
+        DEFAULT_JOB_QUEUE,
+        (size_t)DEFAULT_RUN_STORE_MB * 1024 * 1024,
+        DEFAULT_COMPRESS_LEVEL,
+        DEFAULT_COMPRESS_MIN
+    };
+    int server = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--server") == 0) {
+            server = 1;
+            continue;
+        }
+        long value = i + 1 < argc ? parse_count(argv[i + 1]) : -1;
+        if (value < 0 || value > 1 << 20) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--cache-mb") == 0) {
+            options.cache_bytes = (size_t)value * 1024 * 1024;
+        } else if (strcmp(argv[i], "--http-threads") == 0 && value > 0) {
+            options.http_threads = (int)value;
+        } else if (strcmp(argv[i], "--job-workers") == 0 && value > 0) {
+            options.job_workers = (int)value;
+        } else if (strcmp(argv[i], "--job-queue") == 0) {
+            options.job_queue_size = (int)value;
+        } else if (strcmp(argv[i], "--run-store-mb") == 0) {
+            options.run_store_bytes = (size_t)value * 1024 * 1024;
+        } else if (strcmp(argv[i], "--compress-level") == 0 && value <= 9) {
+            options.compression_level = (int)value;
+        } else if (strcmp(argv[i], "--compress-min") == 0) {
+            options.compression_min_size = (size_t)value;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (!server) {
+        usage(argv[0]);
         return 1;
     }
-    
-   
-    return StartHttpServer();
-}
\ No newline at end of file
+
+    return StartHttpServer(&options);
+}
@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../Include/Workload.h"
+
+// Converts a workload between the text config format and the binary format.
+int main(int argc, char *argv[]) {
+    int to_text = 0;
+    char* paths[2];
+    int nb_paths = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--text") == 0) {
+            to_text = 1;
+        } else if (nb_paths < 2) {
+            paths[nb_paths++] = argv[i];
+        }
+    }
+
+    if (nb_paths < 2) {
+        fprintf(stderr, "Usage: %s <input> <output> [--text]\n", argv[0]);
+        fprintf(stderr, "\nThe input may be either format; the output is binary unless --text is given.\n");
+        fprintf(stderr, "\nExamples:\n");
+        fprintf(stderr, "  %s config.txt config.bin\n", argv[0]);
+        fprintf(stderr, "  %s config.bin config.txt --text\n", argv[0]);
+        return 1;
+    }
+
+    workload* w = workload_open(paths[0]);
+    if (!w) {
+        fprintf(stderr, "Error: Failed to load workload: %s\n", paths[0]);
+        return 1;
+    }
+
+    FILE* out = fopen(paths[1], to_text ? "w" : "wb");
+    if (!out) {
+        fprintf(stderr, "Error: Cannot open output file: %s\n", paths[1]);
+        workload_close(w);
+        return 1;
+    }
+
+    int status = to_text ? workload_write_text(out, w->processes, w->n)
+                         : workload_write_binary(out, w->processes, w->n);
+    if (fclose(out) != 0) status = -1;
+    workload_close(w);
+
+    if (status != 0) {
+        fprintf(stderr, "Error: Failed to write %s\n", paths[1]);
+        return 1;
+    }
+    return 0;
+}
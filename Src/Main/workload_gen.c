@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../Include/Generator.h"
+#include "../../Include/Workload.h"
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [options] [output]\n", prog);
+    fprintf(stderr, "\nWrites a synthetic workload to output (default stdout) as text, or binary with --binary.\n");
+    fprintf(stderr, "\nOptions:\n");
+    fprintf(stderr, "  -n N                     processes (default 1000)\n");
+    fprintf(stderr, "  --seed S                 the same seed and options give the same workload (default 1)\n");
+    fprintf(stderr, "  --arrivals poisson|bursty\n");
+    fprintf(stderr, "  --rate R                 arrivals per time unit, between bursts when bursty (default 0.1)\n");
+    fprintf(stderr, "  --burst-rate R           arrivals per time unit during a burst (default 2)\n");
+    fprintf(stderr, "  --calm T --burst T       mean time between bursts and burst length (default 500, 50)\n");
+    fprintf(stderr, "  --exec exponential|pareto|bimodal\n");
+    fprintf(stderr, "  --exec-mean M            exponential mean, Pareto minimum or short mode mean (default 8)\n");
+    fprintf(stderr, "  --pareto-shape A         Pareto shape (default 1.5)\n");
+    fprintf(stderr, "  --exec-long M --long-share F   bimodal long mode mean and share (default 100, 0.1)\n");
+    fprintf(stderr, "  --max-exec N             exec_time cap (default 100000)\n");
+    fprintf(stderr, "  --priorities MIN:MAX     uniform priority range (default 0:7)\n");
+    fprintf(stderr, "  --events M               mean events per process (default 1)\n");
+    fprintf(stderr, "\nExamples:\n");
+    fprintf(stderr, "  %s -n 100 --seed 7 config.txt\n", prog);
+    fprintf(stderr, "  %s -n 1000000 --arrivals bursty --exec pareto --binary load.bin\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    gen_params params;
+    gen_defaults(&params);
+    int binary = 0;
+    const char* path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        int used = 1;
+        if (strcmp(arg, "--binary") == 0) {
+            binary = 1;
+            used = 0;
+        } else if (arg[0] != '-' || strcmp(arg, "-") == 0) {
+            used = path == NULL ? 0 : -1;
+            path = arg;
+        } else if (value == NULL) {
+            used = -1;
+        } else if (strcmp(arg, "-n") == 0) {
+            params.nb_processes = atoi(value);
+        } else if (strcmp(arg, "--seed") == 0) {
+            params.seed = strtoull(value, NULL, 0);
+        } else if (strcmp(arg, "--arrivals") == 0) {
+            if (strcmp(value, "poisson") == 0) params.arrivals = ARRIVALS_POISSON;
+            else if (strcmp(value, "bursty") == 0) params.arrivals = ARRIVALS_BURSTY;
+            else used = -1;
+        } else if (strcmp(arg, "--rate") == 0) {
+            params.rate = atof(value);
+        } else if (strcmp(arg, "--burst-rate") == 0) {
+            params.burst_rate = atof(value);
+        } else if (strcmp(arg, "--calm") == 0) {
+            params.calm_length = atof(value);
+        } else if (strcmp(arg, "--burst") == 0) {
+            params.burst_length = atof(value);
+        } else if (strcmp(arg, "--exec") == 0) {
+            if (strcmp(value, "exponential") == 0) params.exec = EXEC_EXPONENTIAL;
+            else if (strcmp(value, "pareto") == 0) params.exec = EXEC_PARETO;
+            else if (strcmp(value, "bimodal") == 0) params.exec = EXEC_BIMODAL;
+            else used = -1;
+        } else if (strcmp(arg, "--exec-mean") == 0) {
+            params.exec_mean = atof(value);
+        } else if (strcmp(arg, "--pareto-shape") == 0) {
+            params.pareto_shape = atof(value);
+        } else if (strcmp(arg, "--exec-long") == 0) {
+            params.exec_long = atof(value);
+        } else if (strcmp(arg, "--long-share") == 0) {
+            params.long_share = atof(value);
+        } else if (strcmp(arg, "--max-exec") == 0) {
+            params.max_exec = atoi(value);
+        } else if (strcmp(arg, "--priorities") == 0) {
+            if (sscanf(value, "%d:%d", &params.min_priority, &params.max_priority) != 2) used = -1;
+        } else if (strcmp(arg, "--events") == 0) {
+            params.events_mean = atof(value);
+        } else {
+            used = -1;
+        }
+
+        if (used < 0) {
+            usage(argv[0]);
+            return 1;
+        }
+        i += used;
+    }
+
+    const char* error = NULL;
+    if (gen_check(&params, &error) != 0) {
+        fprintf(stderr, "Error: %s\n", error);
+        return 1;
+    }
+
+    process* processes = gen_workload(&params);
+    if (!processes) {
+        fprintf(stderr, "Error: Failed to generate the workload\n");
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (path != NULL && strcmp(path, "-") != 0) {
+        out = fopen(path, binary ? "wb" : "w");
+        if (!out) {
+            fprintf(stderr, "Error: Cannot open output file: %s\n", path);
+            free(processes);
+            return 1;
+        }
+    }
+
+    int status = binary ? workload_write_binary(out, processes, params.nb_processes)
+                        : workload_write_text(out, processes, params.nb_processes);
+    if (out != stdout ? fclose(out) != 0 : fflush(out) != 0) status = -1;
+    free(processes);
+
+    if (status != 0) {
+        fprintf(stderr, "Error: Failed to write %s\n", path ? path : "output");
+        return 1;
+    }
+    return 0;
+}
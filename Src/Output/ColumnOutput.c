@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../Include/ColumnOutput.h"
+#include "../../Include/Intern.h"
+
+static int column_push(int_column* c, int32_t value){
+    if (c->n == c->cap){
+        size_t cap = c->cap ? c->cap * 2 : 1024;
+        int32_t* bigger = (int32_t*)realloc(c->v, cap * sizeof(int32_t));
+        if (bigger == NULL) return -1;
+        c->v = bigger;
+        c->cap = cap;
+    }
+    c->v[c->n++] = value;
+    return 0;
+}
+
+static int column_write(FILE* out, const int32_t* v, size_t n){
+    return n == 0 || fwrite(v, sizeof(int32_t), n, out) == n ? 0 : -1;
+}
+
+static void free_writer(columns_writer* w){
+    free(w->pid.v);
+    free(w->ts.v);
+    free(w->te.v);
+    free(w->cpu.v);
+    free(w->first_event.v);
+    free(w->event_time.v);
+    free(w->event_comment.v);
+    free(w);
+}
+
+columns_writer* columns_writer_create(FILE* out, const char* algorithm, const process* processes, int nbProc, int nb_cpus){
+    columns_writer* w = (columns_writer*)calloc(1, sizeof(columns_writer));
+    if (w == NULL) return NULL;
+    w->out = out;
+    w->processes = processes;
+    memcpy(w->h.magic, COLUMNS_MAGIC, 4);
+    w->h.version = COLUMNS_VERSION;
+    w->h.nb_processes = nbProc;
+    w->h.nb_cpus = nb_cpus;
+    strncpy(w->h.algorithm, algorithm, sizeof(w->h.algorithm) - 1);
+    if (column_push(&w->first_event, 0) != 0){
+        free_writer(w);
+        return NULL;
+    }
+    return w;
+}
+
+int columns_write_execute(void* ctx, const execute* e){
+    columns_writer* w = (columns_writer*)ctx;
+    int err = column_push(&w->pid, e->p->pid) | column_push(&w->ts, e->ts) |
+              column_push(&w->te, e->te) | column_push(&w->cpu, e->cpu);
+    for (int j = 0; j < e->event_count && err == 0; j++){
+        err = column_push(&w->event_time, event_time(e, &e->events[j])) |
+              column_push(&w->event_comment, (int32_t)e->events[j].comment_id);
+    }
+    return err | column_push(&w->first_event, (int32_t)w->event_time.n);
+}
+
+void columns_writer_set_comments(columns_writer* w, const comment_table* comments){
+    w->comments = comments;
+}
+
+// Strings are the process names in table order, then the comments in order of
+// first use; comments switch from intern ids to these ids here.
+int columns_writer_finish(columns_writer* w){
+    uint32_t nb_comments = comment_table_count(w->comments);
+    uint32_t nb_names = w->h.nb_processes;
+    int32_t* local = (int32_t*)malloc((nb_comments + 1) * sizeof(int32_t));
+    int_column offsets = {0};
+    int_column names = {0};
+    int_column used = {0};
+    int err = local == NULL || column_push(&offsets, 0) != 0 || column_push(&offsets, 0) != 0;
+
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < nb_names && !err; i++){
+        size += strlen(w->processes[i].name);
+        err = column_push(&names, (int32_t)(i + 1)) | column_push(&offsets, (int32_t)size);
+    }
+    if (!err){
+        memset(local, 0xff, (nb_comments + 1) * sizeof(int32_t));
+        local[0] = 0;
+    }
+    for (size_t i = 0; i < w->event_comment.n && !err; i++){
+        uint32_t id = (uint32_t)w->event_comment.v[i];
+        if (id >= nb_comments) id = 0;
+        if (local[id] < 0){
+            local[id] = (int32_t)(nb_names + 1 + used.n);
+            size += strlen(comment_table_text(w->comments, id));
+            err = column_push(&used, (int32_t)id) | column_push(&offsets, (int32_t)size);
+        }
+        w->event_comment.v[i] = local[id];
+    }
+
+    w->h.nb_slices = w->pid.n;
+    w->h.nb_events = w->event_time.n;
+    w->h.nb_strings = offsets.n - 1;
+    w->h.strings_size = size;
+
+    if (!err){
+        FILE* out = w->out;
+        int32_t* values = (int32_t*)malloc((nb_names + 1) * sizeof(int32_t));
+        err = values == NULL || fwrite(&w->h, sizeof(w->h), 1, out) != 1;
+
+        // The process table is gathered one field at a time.
+        for (int field = 0; field < 4 && !err; field++){
+            for (uint32_t i = 0; i < nb_names; i++){
+                const process* p = &w->processes[i];
+                values[i] = field == 0 ? p->pid : field == 1 ? p->arrival :
+                             field == 2 ? p->exec_time : p->priority;
+            }
+            err = column_write(out, values, nb_names);
+            if (field == 0 && !err)
+                err = column_write(out, names.v, nb_names);
+        }
+        free(values);
+
+        err = err || column_write(out, w->pid.v, w->pid.n) || column_write(out, w->ts.v, w->ts.n) ||
+              column_write(out, w->te.v, w->te.n) || column_write(out, w->cpu.v, w->cpu.n) ||
+              column_write(out, w->first_event.v, w->first_event.n) ||
+              column_write(out, w->event_time.v, w->event_time.n) ||
+              column_write(out, w->event_comment.v, w->event_comment.n) ||
+              column_write(out, offsets.v, offsets.n);
+        for (uint32_t i = 0; i < nb_names && !err; i++){
+            const char* name = w->processes[i].name;
+            err = fwrite(name, 1, strlen(name), out) != strlen(name);
+        }
+        for (size_t i = 0; i < used.n && !err; i++){
+            const char* text = comment_table_text(w->comments, (uint32_t)used.v[i]);
+            err = fwrite(text, 1, strlen(text), out) != strlen(text);
+        }
+        err = err || ferror(out);
+    }
+
+    free(local);
+    free(offsets.v);
+    free(names.v);
+    free(used.v);
+    free_writer(w);
+    return err ? -1 : 0;
+}
@@ -0,0 +1,378 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../Include/JsonOutput.h"
+#include "../../Include/Intern.h"
+
+#define JSON_BUFFER_SIZE (256 * 1024)
+
+static void free_writer(json_writer* w) {
+    free(w->buf);
+    free(w->busy);
+    free(w->slices);
+    free(w->end);
+    run_metrics_free(w->metrics);
+    free(w->reservoir);
+    free(w);
+}
+
+static json_writer* alloc_writer(FILE* out, int nb_cpus) {
+    json_writer* w = (json_writer*)calloc(1, sizeof(json_writer));
+    if (!w) return NULL;
+    w->out = out;
+    w->nb_cpus = nb_cpus;
+    w->busy = calloc(nb_cpus, sizeof(int));
+    w->slices = calloc(nb_cpus, sizeof(int));
+    w->end = calloc(nb_cpus, sizeof(int));
+    if (!w->busy || !w->slices || !w->end) {
+        free_writer(w);
+        return NULL;
+    }
+    return w;
+}
+
+static void flush_buf(json_writer* w) {
+    if (w->len > 0) fwrite(w->buf, 1, w->len, w->out);
+    w->len = 0;
+}
+
+static void put_mem(json_writer* w, const char* s, size_t n) {
+    if (w->len + n > JSON_BUFFER_SIZE) {
+        flush_buf(w);
+        if (n > JSON_BUFFER_SIZE) {
+            fwrite(s, 1, n, w->out);
+            return;
+        }
+    }
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+static void put_str(json_writer* w, const char* s) {
+    put_mem(w, s, strlen(s));
+}
+
+static void put_raw(json_writer* w, const char* s, size_t n) {
+    if (w->buf) put_mem(w, s, n);
+    else fwrite(s, 1, n, w->out);
+}
+
+// The contents of a JSON string: quotes, backslashes and control characters
+// are escaped, everything else goes out as it is in runs.
+static void put_escaped(json_writer* w, const char* s) {
+    const char* run = s;
+    for (; *s; s++) {
+        unsigned char ch = (unsigned char)*s;
+        if (ch >= 0x20 && ch != '"' && ch != '\\') continue;
+        put_raw(w, run, s - run);
+        char esc[7] = { '\\', (char)ch, 0 };
+        size_t n = 2;
+        if (ch == '\n') esc[1] = 'n';
+        else if (ch == '\r') esc[1] = 'r';
+        else if (ch == '\t') esc[1] = 't';
+        else if (ch < 0x20) n = (size_t)snprintf(esc, sizeof(esc), "\\u%04x", ch);
+        put_raw(w, esc, n);
+        run = s + 1;
+    }
+    put_raw(w, run, s - run);
+}
+
+// Digits are produced backwards into a small scratch buffer.
+static void put_int(json_writer* w, int v) {
+    char tmp[12];
+    char* p = tmp + sizeof(tmp);
+    unsigned int u = v < 0 ? 0u - (unsigned int)v : (unsigned int)v;
+    do {
+        *--p = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (v < 0) *--p = '-';
+    put_mem(w, p, tmp + sizeof(tmp) - p);
+}
+
+static void put_field(json_writer* w, const char* key, int v) {
+    put_str(w, key);
+    put_int(w, v);
+}
+
+json_writer* json_writer_create(FILE* out, const char* algorithm, int nbProc, int nb_cpus) {
+    json_writer* w = alloc_writer(out, nb_cpus);
+    if (!w) return NULL;
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"success\": true,\n");
+    fprintf(out, "  \"algorithm\": \"");
+    put_escaped(w, algorithm);
+    fprintf(out, "\",\n");
+    fprintf(out, "  \"totalProcesses\": %d,\n", nbProc);
+    fprintf(out, "  \"cpus\": %d,\n", nb_cpus);
+    fprintf(out, "  \"executes\": [\n");
+    return w;
+}
+
+json_writer* json_writer_create_compact(FILE* out, const char* algorithm, const process* processes, int nbProc, int nb_cpus) {
+    json_writer* w = alloc_writer(out, nb_cpus);
+    if (!w) return NULL;
+    w->buf = (char*)malloc(JSON_BUFFER_SIZE);
+    if (!w->buf) {
+        free_writer(w);
+        return NULL;
+    }
+
+    put_str(w, "{\"success\":true,\"format\":\"compact\",\"algorithm\":\"");
+    put_escaped(w, algorithm);
+    put_field(w, "\",\"totalProcesses\":", nbProc);
+    put_field(w, ",\"cpus\":", nb_cpus);
+    w->processes = processes;
+    w->nb_processes = nbProc;
+    return w;
+}
+
+static void write_process_table(json_writer* w) {
+    put_str(w, ",\"processes\":[");
+    for (int i = 0; i < w->nb_processes; i++) {
+        const process* p = &w->processes[i];
+        put_field(w, i > 0 ? ",{\"pid\":" : "{\"pid\":", p->pid);
+        put_field(w, ",\"ppid\":", p->ppid);
+        put_str(w, ",\"name\":\"");
+        put_escaped(w, p->name);
+        put_field(w, "\",\"arrival\":", p->arrival);
+        put_field(w, ",\"exec_time\":", p->exec_time);
+        put_field(w, ",\"priority\":", p->priority);
+        put_str(w, ",\"events\":[");
+        for (int j = 0; j < p->nbEvents; j++) {
+            put_field(w, j > 0 ? ",{\"t\":" : "{\"t\":", p->events[j].t);
+            put_str(w, ",\"comment\":\"");
+            put_escaped(w, comment_table_text(w->comments, p->events[j].comment_id));
+            put_str(w, "\"}");
+        }
+        put_str(w, "]}");
+    }
+    put_str(w, "],\"executes\":[");
+    w->processes = NULL;
+}
+
+static void write_compact_execute(json_writer* w, const execute* e) {
+    if (w->processes) write_process_table(w);
+    put_field(w, w->written > 0 ? ",{\"pid\":" : "{\"pid\":", e->p->pid);
+    put_field(w, ",\"ts\":", e->ts);
+    put_field(w, ",\"te\":", e->te);
+    put_field(w, ",\"cpu\":", e->cpu);
+    put_field(w, ",\"offset\":", e->offset);
+    put_str(w, ",\"event_ids\":[");
+    int first = e->event_count > 0 ? (int)(e->events - e->p->events) : 0;
+    for (int j = 0; j < e->event_count; j++) {
+        if (j > 0) put_mem(w, ",", 1);
+        put_int(w, first + j);
+    }
+    put_str(w, "]}");
+}
+
+static void write_full_execute(json_writer* w, const execute* e) {
+    FILE* out = w->out;
+
+    if (w->written > 0) fprintf(out, ",\n");
+    fprintf(out, "    {\n");
+    
+    fprintf(out, "      \"p\": {\n");
+    fprintf(out, "        \"pid\": %d,\n", e->p->pid);
+    fprintf(out, "        \"ppid\": %d,\n", e->p->ppid);
+    fprintf(out, "        \"name\": \"");
+    put_escaped(w, e->p->name);
+    fprintf(out, "\",\n");
+    fprintf(out, "        \"arrival\": %d,\n", e->p->arrival);
+    fprintf(out, "        \"exec_time\": %d,\n", e->p->exec_time);
+    fprintf(out, "        \"rem_time\": %d,\n", e->p->rem_time);
+    fprintf(out, "        \"cpu_usage\": %d,\n", e->p->cpu_usage);
+    fprintf(out, "        \"priority\": %d,\n", e->p->priority);
+    fprintf(out, "        \"nbEvents\": %d,\n", e->p->nbEvents);
+    
+    fprintf(out, "        \"events\": [\n");
+    for (int j = 0; j < e->p->nbEvents; j++) {
+        fprintf(out, "          {\n");
+        fprintf(out, "            \"t\": %d,\n", e->p->events[j].t);
+        fprintf(out, "            \"comment\": \"");
+        put_escaped(w, comment_table_text(w->comments, e->p->events[j].comment_id));
+        fprintf(out, "\"\n");
+        fprintf(out, "          }");
+        if (j < e->p->nbEvents - 1) fprintf(out, ",");
+        fprintf(out, "\n");
+    }
+    fprintf(out, "        ]\n");
+    fprintf(out, "      },\n");
+    
+    fprintf(out, "      \"ts\": %d,\n", e->ts);
+    fprintf(out, "      \"te\": %d,\n", e->te);
+    fprintf(out, "      \"cpu\": %d,\n", e->cpu);
+    
+    fprintf(out, "      \"event_count\": %d,\n", e->event_count);
+    
+    fprintf(out, "      \"events\": [\n");
+    for (int j = 0; j < e->event_count; j++) {
+        fprintf(out, "        {\n");
+        fprintf(out, "          \"t\": %d,\n", event_time(e, &e->events[j]));
+        fprintf(out, "          \"comment\": \"");
+        put_escaped(w, comment_table_text(w->comments, e->events[j].comment_id));
+        fprintf(out, "\"\n");
+        fprintf(out, "        }");
+        if (j < e->event_count - 1) fprintf(out, ",");
+        fprintf(out, "\n");
+    }
+    fprintf(out, "      ]\n");
+    fprintf(out, "    }");
+}
+
+static void write_execute(json_writer* w, const execute* e) {
+    if (w->buf) write_compact_execute(w, e);
+    else write_full_execute(w, e);
+    w->written++;
+}
+
+// splitmix64, so a seed gives the same sample everywhere.
+static uint64_t next_random(json_writer* w) {
+    uint64_t z = (w->rng += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Algorithm R: slice i replaces a random held one with probability size / (i + 1).
+// The reservoir grows with the run, so a large size costs nothing on a short one.
+static int sample_execute(json_writer* w, const execute* e) {
+    int slot = w->count;
+    if (w->count >= w->sample_size) {
+        uint64_t r = next_random(w) % ((uint64_t)w->count + 1);
+        if (r >= (uint64_t)w->sample_size) return 0;
+        slot = (int)r;
+    } else if (slot == w->reservoir_cap) {
+        int cap = w->reservoir_cap * 2 < w->sample_size ? w->reservoir_cap * 2 : w->sample_size;
+        sampled_slice* bigger = (sampled_slice*)realloc(w->reservoir, cap * sizeof(sampled_slice));
+        if (!bigger) return -1;
+        w->reservoir = bigger;
+        w->reservoir_cap = cap;
+    }
+    w->reservoir[slot].e = *e;
+    w->reservoir[slot].p = *e->p;
+    w->reservoir[slot].index = w->count;
+    return 0;
+}
+
+int json_write_execute(void* ctx, const execute* e) {
+    json_writer* w = (json_writer*)ctx;
+
+    if (w->detail == DETAIL_FULL || (w->sample_every > 0 && w->count % w->sample_every == 0))
+        write_execute(w, e);
+    else if (w->reservoir && sample_execute(w, e) != 0)
+        return -1;
+
+    w->busy[e->cpu] += e->te - e->ts;
+    w->slices[e->cpu]++;
+    if (e->te > w->end[e->cpu]) w->end[e->cpu] = e->te;
+    if (w->metrics) run_metrics_add(w->metrics, e);
+    w->count++;
+    return ferror(w->out) ? -1 : 0;
+}
+
+void json_writer_set_stats(json_writer* w, sched_stats* stats) {
+    w->stats = stats;
+}
+
+void json_writer_set_comments(json_writer* w, const comment_table* comments) {
+    w->comments = comments;
+}
+
+int json_writer_enable_metrics(json_writer* w, const process* processes, int nbProc) {
+    w->metrics = run_metrics_create(processes, nbProc, w->nb_cpus);
+    return w->metrics ? 0 : -1;
+}
+
+void json_writer_set_summary(json_writer* w) {
+    w->detail = DETAIL_SUMMARY;
+}
+
+int json_writer_set_sampling(json_writer* w, int every, int size, uint64_t seed) {
+    w->detail = DETAIL_SAMPLED;
+    if (size > 0) {
+        w->reservoir_cap = size < 1024 ? size : 1024;
+        w->reservoir = (sampled_slice*)malloc(w->reservoir_cap * sizeof(sampled_slice));
+        if (!w->reservoir) return -1;
+        w->sample_size = size;
+        w->rng = seed;
+    } else {
+        w->sample_every = every > 0 ? every : JSON_SAMPLE_EVERY;
+    }
+    return 0;
+}
+
+static int compare_sampled(const void* a, const void* b) {
+    return ((const sampled_slice*)a)->index - ((const sampled_slice*)b)->index;
+}
+
+// The reservoir is written once the run is over, back in emission order.
+static void write_reservoir(json_writer* w) {
+    int n = w->count < w->sample_size ? w->count : w->sample_size;
+    qsort(w->reservoir, n, sizeof(sampled_slice), compare_sampled);
+    for (int i = 0; i < n; i++) {
+        w->reservoir[i].e.p = &w->reservoir[i].p;
+        write_execute(w, &w->reservoir[i].e);
+    }
+}
+
+static const char* detail_name(json_detail detail) {
+    return detail == DETAIL_SUMMARY ? "summary" : "sampled";
+}
+
+static void finish_compact(json_writer* w) {
+    if (w->processes) write_process_table(w);
+    put_str(w, "],\"timelines\":[");
+    for (int c = 0; c < w->nb_cpus; c++) {
+        put_field(w, c > 0 ? ",{\"cpu\":" : "{\"cpu\":", c);
+        put_field(w, ",\"slices\":", w->slices[c]);
+        put_field(w, ",\"busy\":", w->busy[c]);
+        put_field(w, ",\"end\":", w->end[c]);
+        put_mem(w, "}", 1);
+    }
+    put_mem(w, "]", 1);
+    if (w->detail != DETAIL_FULL) {
+        put_str(w, ",\"detail\":\"");
+        put_str(w, detail_name(w->detail));
+        put_field(w, "\",\"totalSlices\":", w->count);
+    }
+    flush_buf(w);
+}
+
+int json_writer_finish(json_writer* w) {
+    FILE* out = w->out;
+    uint64_t start = w->stats ? stats_now() : 0;
+
+    if (w->reservoir) write_reservoir(w);
+    if (w->buf) {
+        finish_compact(w);
+    } else {
+        if (w->written > 0) fprintf(out, "\n");
+        fprintf(out, "  ],\n");
+        fprintf(out, "  \"timelines\": [\n");
+        for (int c = 0; c < w->nb_cpus; c++) {
+            fprintf(out, "    { \"cpu\": %d, \"slices\": %d, \"busy\": %d, \"end\": %d }", c, w->slices[c], w->busy[c], w->end[c]);
+            if (c < w->nb_cpus - 1) fprintf(out, ",");
+            fprintf(out, "\n");
+        }
+        fprintf(out, "  ]");
+        if (w->detail != DETAIL_FULL)
+            fprintf(out, ",\n  \"detail\": \"%s\",\n  \"totalSlices\": %d", detail_name(w->detail), w->count);
+    }
+    if (w->stats) {
+        w->stats->finish_ns += stats_now() - start;
+        fprintf(out, w->buf ? ",\"stats\":" : ",\n  \"stats\": ");
+        stats_write_json(out, w->stats);
+    }
+    if (w->metrics) {
+        fprintf(out, w->buf ? ",\"metrics\":" : ",\n  \"metrics\": ");
+        run_metrics_write_json(out, w->metrics, w->detail != DETAIL_SUMMARY);
+    }
+    fprintf(out, w->buf ? "}\n" : "\n}\n");
+
+    int ret = ferror(out) ? -1 : 0;
+    free_writer(w);
+    return ret;
+}
@@ -1,86 +1,191 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
-#include "../../Include/Utils.h"
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../../Include/Parser.h"
+#include "../../Include/Intern.h"
 
-#define MAX_PROC 100
-#define MAX_LINE 256
+#define READ_CHUNK (64 * 1024)
 
-int parser(FILE *f, process* tab, int *nbProc) {
-    char line[MAX_LINE];
+typedef struct scanner{
+    const char* p;
+    const char* end;
+} scanner;
+
+static const unsigned char blanks[256] = {
+    [' '] = 1, ['\t'] = 1, ['\r'] = 1, ['\v'] = 1, ['\f'] = 1,
+};
+
+static int is_blank(char c){
+    return blanks[(unsigned char)c];
+}
+
+static void skip_blanks(scanner* s){
+    while (s->p < s->end && is_blank(*s->p))
+        s->p++;
+}
+
+static void skip_line(scanner* s){
+    const char* nl = memchr(s->p, '\n', s->end - s->p);
+    s->p = nl ? nl + 1 : s->end;
+}
+
+// Next whitespace-separated token on the current line; 0 at the end of the line.
+static int next_token(scanner* s, const char** tok, size_t* len){
+    skip_blanks(s);
+    if (s->p == s->end || *s->p == '\n')
+        return 0;
+    *tok = s->p;
+    while (s->p < s->end && *s->p != '\n' && !is_blank(*s->p))
+        s->p++;
+    *len = s->p - *tok;
+    return 1;
+}
+
+// Reads the digits in place instead of re-scanning a token.
+static int next_int(scanner* s, int* out){
+    skip_blanks(s);
+    const char* p = s->p;
+    int neg = 0;
+    if (p < s->end && (*p == '-' || *p == '+')){
+        neg = *p == '-';
+        p++;
+    }
+
+    const char* digits = p;
+    long long v = 0;
+    while (p < s->end && (unsigned)(*p - '0') < 10){
+        v = v * 10 + (*p - '0');
+        if (v > INT_MAX)
+            return 0;
+        p++;
+    }
+    if (p == digits || (p < s->end && *p != '\n' && !is_blank(*p)))
+        return 0;
+
+    s->p = p;
+    *out = (int)(neg ? -v : v);
+    return 1;
+}
+
+// Upper bounds taken before parsing, so the output block is allocated once
+// and filled in place: at most one process per line, and each event takes at
+// least " t c", so four bytes.
+static size_t count_lines(const char* p, const char* end){
+    size_t n = 1;
+    while ((p = memchr(p, '\n', end - p)) != NULL){
+        n++;
+        p++;
+    }
+    return n;
+}
+
+// One line: name arrival exec_time priority nbEvents [t comment]...
+static int parse_line(scanner* s, process* p, event* pool, size_t* nb_events, size_t max_events){
+    const char* tok;
+    size_t len;
+    if (!next_token(s, &tok, &len))
+        return -1;
+    if (len >= sizeof(p->name))
+        len = sizeof(p->name) - 1;
+    memcpy(p->name, tok, len);
+    p->name[len] = '\0';
+
+    if (!next_int(s, &p->arrival) || !next_int(s, &p->exec_time) ||
+        !next_int(s, &p->priority) || !next_int(s, &p->nbEvents) || p->nbEvents < 0 ||
+        (size_t)p->nbEvents > max_events - *nb_events)
+        return -1;
+
+    p->pid = 0;
+    p->ppid = 0;
+    p->rem_time = p->exec_time;
+    p->cpu_usage = 0;
+    p->events = p->nbEvents ? pool + *nb_events : NULL;
+    for (int i = 0; i < p->nbEvents; i++){
+        event* ev = &p->events[i];
+        if (!next_int(s, &ev->t) || !next_token(s, &tok, &len))
+            return -1;
+        ev->comment_id = intern_comment_len(tok, len);
+    }
+    *nb_events += p->nbEvents;
+    sort_events(p);
+    return 0;
+}
+
+int parse_workload(const char* buf, size_t size, process** tab, int* nbProc){
+    scanner s = { buf, buf + size };
+    size_t max_procs = count_lines(buf, buf + size);
+    size_t max_events = size / 4;
+
+    // Processes and events share one block, so free(*tab) releases both. Only
+    // the pages actually written get backed by memory.
+    *tab = NULL;
     *nbProc = 0;
-    
-    while (fgets(line, sizeof(line), f)) {
-        if (*nbProc >= MAX_PROC) {
-            return -1; 
-        }
-        
-        line[strcspn(line, "\n")] = '\0';
-        
-        char *line_ptr = line;
-        while (isspace((unsigned char)*line_ptr)) 
-            line_ptr++;
-        
-    
-        if (*line_ptr == '#' || *line_ptr == '\0')
+    if (max_procs > INT_MAX)
+        return -1;
+    size_t head = max_procs * sizeof(process);
+    process* out = (process*)malloc(head + max_events * sizeof(event));
+    if (out == NULL)
+        return -1;
+    event* pool = (event*)((char*)out + head);
+
+    int n = 0;
+    size_t nb_events = 0;
+    while (s.p < s.end){
+        skip_blanks(&s);
+        if (s.p == s.end) break;
+        if (*s.p == '\n' || *s.p == '#'){
+            skip_line(&s);
             continue;
-        
-        char name[20];
-        int arrival, exec_time, priority, nbEvents;
-        
-        int parsed = sscanf(line_ptr, "%s %d %d %d %d", name, &arrival, &exec_time, &priority, &nbEvents);
-        if (parsed != 5) {
-            return -1;
         }
 
-        tab[*nbProc].pid = *nbProc + 1;
-        tab[*nbProc].ppid = 0;
-        strcpy(tab[*nbProc].name, name);
-        tab[*nbProc].arrival = arrival;
-        tab[*nbProc].exec_time = exec_time;
-        tab[*nbProc].rem_time = exec_time; 
-        tab[*nbProc].priority = priority;
-        tab[*nbProc].nbEvents = nbEvents;
-        tab[*nbProc].cpu_usage = 0;
-        
-        if (nbEvents == 0) {
-            tab[*nbProc].events = NULL;
-        } else {
-            tab[*nbProc].events = (event*)malloc(nbEvents * sizeof(event));
-            if (tab[*nbProc].events == NULL) {
-                return -1; 
-            }
-            
-            char line_copy[MAX_LINE];
-            strcpy(line_copy, line_ptr);
-            
-            char *token = strtok(line_copy, " \t");
-            for (int i = 0; i < 5 && token != NULL; i++) {
-                token = strtok(NULL, " \t");
-            }
-            
-            for (int event_idx = 0; event_idx < nbEvents; event_idx++) {
-                if (token == NULL) {
-                    free(tab[*nbProc].events);
-                    return -1; 
-                }
-                
-                tab[*nbProc].events[event_idx].t = atoi(token);
-                token = strtok(NULL, " \t");
-                
-                if (token == NULL) {
-                    free(tab[*nbProc].events);
-                    return -1; 
-                }
-                
-                strcpy(tab[*nbProc].events[event_idx].comment, token);
-                token = strtok(NULL, " \t");
-            }
+        if (parse_line(&s, &out[n], pool, &nb_events, max_events) != 0){
+            free(out);
+            return -1;
         }
-        
-        (*nbProc)++;
+        out[n].pid = n + 1;
+        n++;
+        skip_line(&s);
     }
-    
+
+    *tab = out;
+    *nbProc = n;
     return 0;
 }
+
+// Regular files are mapped; pipes and other streams are read into memory first.
+int parser(FILE *f, process** tab, int *nbProc){
+    struct stat st;
+    long start = ftell(f);
+    if (start >= 0 && fstat(fileno(f), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > start){
+        void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+        if (map != MAP_FAILED){
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+            int ret = parse_workload((const char*)map + start, st.st_size - start, tab, nbProc);
+            munmap(map, st.st_size);
+            return ret;
+        }
+    }
+
+    char* buf = NULL;
+    size_t size = 0, cap = 0, got;
+    do {
+        if (size + READ_CHUNK > cap){
+            cap = cap ? cap * 2 : READ_CHUNK;
+            char* bigger = realloc(buf, cap);
+            if (bigger == NULL){
+                free(buf);
+                return -1;
+            }
+            buf = bigger;
+        }
+        got = fread(buf + size, 1, cap - size, f);
+        size += got;
+    } while (got > 0);
+
+    int ret = ferror(f) ? -1 : parse_workload(buf ? buf : "", size, tab, nbProc);
+    free(buf);
+    return ret;
+}
@@ -1,16 +1,24 @@
 #include "../../Include/Queue.h"
+#include "../../Include/Stats.h"
 
 queue create_queue(){
     return create_list();
 }
 
+queue create_queue_in(arena* a){
+    return create_list_in(a);
+}
+
 queue push(queue q, void* dataToPush){
-    add_tail(q, dataToPush);
+    if (add_tail(q, dataToPush) != 0)
+        return NULL;
+    STATS_INC(queue_pushes);
     return q;
 }
 
 queue pop(queue q){
     del_head(q);
+    STATS_INC(queue_pops);
     return q;
 }
 
@@ -20,4 +28,8 @@ void* front(queue q){
 
 int size(queue q){
     return q->sz;
+}
+
+void free_queue(queue q){
+    free_list(q);
 }
\ No newline at end of file
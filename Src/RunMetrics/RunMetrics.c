@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../Include/RunMetrics.h"
+
+#define NOT_YET -1
+
+run_metrics* run_metrics_create(const process* processes, int n, int nb_cpus){
+    run_metrics* m = (run_metrics*)calloc(1, sizeof(run_metrics));
+    if (m == NULL) return NULL;
+    m->procs = (proc_metrics*)malloc((n > 0 ? n : 1) * sizeof(proc_metrics));
+    if (m->procs == NULL){
+        free(m);
+        return NULL;
+    }
+    m->processes = processes;
+    m->n = n;
+    m->nb_cpus = nb_cpus;
+
+    m->start = n > 0 ? processes[0].arrival : 0;
+    for (int i = 0; i < n; i++){
+        proc_metrics* pm = &m->procs[i];
+        pm->first_start = NOT_YET;
+        pm->completion = NOT_YET;
+        pm->last_end = NOT_YET;
+        pm->last_cpu = NOT_YET;
+        pm->preemptions = 0;
+        if (processes[i].arrival < m->start) m->start = processes[i].arrival;
+    }
+    m->end = m->start;
+    return m;
+}
+
+void run_metrics_add(run_metrics* m, const execute* e){
+    const process* p = e->p;
+    proc_metrics* pm = &m->procs[p - m->processes];
+
+    if (pm->first_start == NOT_YET)
+        pm->first_start = e->ts;
+    else if (e->ts != pm->last_end || e->cpu != pm->last_cpu)
+        pm->preemptions++;
+    pm->last_end = e->te;
+    pm->last_cpu = e->cpu;
+    if (e->offset + (e->te - e->ts) >= p->exec_time)
+        pm->completion = e->te;
+
+    m->busy += e->te - e->ts;
+    if (e->te > m->end) m->end = e->te;
+}
+
+int run_metrics_emit(void* ctx, const execute* e){
+    run_metrics_add((run_metrics*)ctx, e);
+    return 0;
+}
+
+void run_metrics_summarize(const run_metrics* m, metrics_summary* s){
+    double waiting = 0, turnaround = 0, response = 0, x = 0, x2 = 0;
+    int started = 0;
+    *s = (metrics_summary){0};
+
+    for (int i = 0; i < m->n; i++){
+        const proc_metrics* pm = &m->procs[i];
+        const process* p = &m->processes[i];
+        s->preemptions += pm->preemptions;
+        if (pm->first_start != NOT_YET){
+            int r = pm->first_start - p->arrival;
+            response += r;
+            if (r > s->max_response) s->max_response = r;
+            started++;
+        }
+        if (pm->completion != NOT_YET){
+            int t = pm->completion - p->arrival;
+            int w = t - p->exec_time;
+            turnaround += t;
+            waiting += w;
+            if (t > s->max_turnaround) s->max_turnaround = t;
+            if (w > s->max_waiting) s->max_waiting = w;
+            double ratio = t > 0 ? (double)p->exec_time / t : 1.0;
+            x += ratio;
+            x2 += ratio * ratio;
+            s->completed++;
+        }
+    }
+
+    s->makespan = m->end - m->start;
+    s->busy = m->busy;
+    s->idle = (long long)m->nb_cpus * s->makespan - m->busy;
+    if (s->makespan > 0){
+        s->utilization = (double)m->busy / ((double)m->nb_cpus * s->makespan);
+        s->throughput = (double)s->completed / s->makespan;
+    }
+    if (started > 0) s->avg_response = response / started;
+    if (s->completed > 0){
+        s->avg_waiting = waiting / s->completed;
+        s->avg_turnaround = turnaround / s->completed;
+        s->fairness = x2 > 0 ? x * x / (s->completed * x2) : 1.0;
+    }
+}
+
+static void write_time(FILE* out, const char* key, int known, int value){
+    if (known) fprintf(out, ",\"%s\":%d", key, value);
+    else fprintf(out, ",\"%s\":null", key);
+}
+
+void run_metrics_write_json(FILE* out, const run_metrics* m, int per_process){
+    metrics_summary s;
+    run_metrics_summarize(m, &s);
+
+    fprintf(out, "{\"completed\":%d,\"makespan\":%d,\"busy\":%lld,\"idle\":%lld,"
+                 "\"utilization\":%.4f,\"throughput\":%.4f,",
+            s.completed, s.makespan, s.busy, s.idle, s.utilization, s.throughput);
+    fprintf(out, "\"waiting\":{\"avg\":%.3f,\"max\":%d},\"turnaround\":{\"avg\":%.3f,\"max\":%d},"
+                 "\"response\":{\"avg\":%.3f,\"max\":%d},\"preemptions\":%lld,",
+            s.avg_waiting, s.max_waiting, s.avg_turnaround, s.max_turnaround,
+            s.avg_response, s.max_response, s.preemptions);
+    if (s.completed > 0) fprintf(out, "\"fairness\":%.4f", s.fairness);
+    else fprintf(out, "\"fairness\":null");
+    if (!per_process){
+        fprintf(out, "}");
+        return;
+    }
+
+    fprintf(out, ",\"processes\":[");
+    for (int i = 0; i < m->n; i++){
+        const proc_metrics* pm = &m->procs[i];
+        const process* p = &m->processes[i];
+        int done = pm->completion != NOT_YET;
+        fprintf(out, i > 0 ? ",{\"pid\":%d" : "{\"pid\":%d", p->pid);
+        write_time(out, "waiting", done, pm->completion - p->arrival - p->exec_time);
+        write_time(out, "turnaround", done, pm->completion - p->arrival);
+        write_time(out, "response", pm->first_start != NOT_YET, pm->first_start - p->arrival);
+        fprintf(out, ",\"preemptions\":%d}", pm->preemptions);
+    }
+    fprintf(out, "]}");
+}
+
+void run_metrics_free(run_metrics* m){
+    if (m == NULL) return;
+    free(m->procs);
+    free(m);
+}
@@ -1,36 +1,50 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "../../Include/Scheduler.h"
+#include "../../Include/Queue.h"
+
+static void* fifo_create(const sim_params* params, arena* a) {
+    (void)params;
+    return create_queue_in(a);
+}
+
+static int fifo_enqueue(void* st, process* p) {
+    return push(st, p) ? 0 : -1;
+}
+
+static process* fifo_pick_next(void* st) {
+    queue q = st;
+    if (size(q) == 0)
+        return NULL;
+    process* p = front(q);
+    pop(q);
+    return p;
+}
+
+// Thieves take the newest arrival, leaving the victim its oldest work.
+// It only leaves the victim once the thief holds it.
+static process* fifo_steal(void* victim, void* thief, process* running) {
+    (void)running;
+    queue q = victim;
+    if (size(q) == 0)
+        return NULL;
+    process* p = get_tail(q);
+    if (!push(thief, p))
+        return NULL;
+    del_tail(q);
+    return p;
+}
+
+const policy fifo_policy = {
+    .name = "Fifo",
+    .params = (const char* const[]){ NULL },
+    .create = fifo_create,
+    .enqueue = fifo_enqueue,
+    .pick_next = fifo_pick_next,
+    .steal = fifo_steal,
+};
 
 execute* fifo_scheduler(process* processes, int n, int* out_count) {
-    qsort(processes, n, sizeof(process), compare_process);
-    execute* result = (execute*)malloc(n * sizeof(execute));
-    if (!result) return NULL;
-    
-    int ts = 0;
-    for (int i = 0; i < n; i++) {
-        if (ts < processes[i].arrival)
-            ts = processes[i].arrival;
-        
-        int te = ts + processes[i].exec_time;
-        
-        int event_count = 0;
-        
-        event* filtered_events = getEvents(processes[i], 0, processes[i].exec_time, &event_count);
-      
-        for (int j = 0; j < event_count; j++) {
-            filtered_events[j].t = ts + filtered_events[j].t;
-        }
-        
-        result[i].p = make_process(&processes[i]);
-        result[i].ts = ts;
-        result[i].te = te;
-        result[i].event_count = event_count;
-        result[i].events = filtered_events;
-        
-        ts = te;
-    }
-    
-    *out_count = n;
-    return result;
-}
\ No newline at end of file
+    sim_params params = {0};
+    return simulate(&fifo_policy, processes, n, &params, out_count);
+}
@@ -1,206 +1,167 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <stdbool.h>
 #include "../../Include/Scheduler.h"
-#include "../../Include/Queue.h"
-#include "../../Include/List.h"
-#include "../../Include/Utils.h"
-
-#define min(a, b) ((a) < (b) ? (a) : (b))
-
-void add_to_queue(queue* q, process* p){
-    if (q == NULL || p == NULL) return;
-    
-    if (size(*q) == 0) {
-        *q = push(*q, p);
-        return;
-    }
-    
-    queue tmp = create_queue();
-    while (size(*q) > 0){
-        process* curr = front(*q);
-        if (curr != NULL && curr->rem_time > p->rem_time){
-            *q = pop(*q);
-            tmp = push(tmp, curr);
-        }
-        else break;
-    }
-    *q = push(*q, p);
-    while (size(tmp) > 0){
-        process* curr = front(tmp);
-        tmp = pop(tmp);
-        *q = push(*q, curr);
+#include "../../Include/Heap.h"
+#include "../../Include/Stats.h"
+
+#define WORD_BITS (8 * (int)sizeof(unsigned long))
+
+// One heap per priority level, ordered by remaining time, plus a bitmap of the non-empty levels.
+typedef struct levels{
+    int nbPriority;
+    heap** queues;
+    unsigned long* bitmap;
+} levels;
+
+static levels* create_levels(arena* a, int nbPriority){
+    levels* lv = (levels*)arena_alloc(a, sizeof(levels));
+    if (lv == NULL) return NULL;
+
+    int words = (nbPriority + WORD_BITS - 1) / WORD_BITS;
+    lv->nbPriority = nbPriority;
+    lv->queues = (heap**)arena_alloc(a, nbPriority * sizeof(heap*));
+    lv->bitmap = (unsigned long*)arena_calloc(a, words, sizeof(unsigned long));
+    if (lv->queues == NULL || lv->bitmap == NULL)
+        return NULL;
+
+    for (int i = 0; i < nbPriority; i++){
+        lv->queues[i] = create_heap_in(a, compare_by_rem_time);
+        if (lv->queues[i] == NULL)
+            return NULL;
     }
+    return lv;
 }
 
-int get_higher_priority(queue* queues, int nbPriority){
-    if (queues == NULL) return -1;
-    
-    for (int i = nbPriority - 1; i >= 0; i--){
-        if (size(queues[i]) > 0)
-            return i;
-    }
-    return -1;
+static int add_to_queue(levels* lv, int priority, process* p){
+    if (lv == NULL || p == NULL) return -1;
+
+    if (heap_push(lv->queues[priority], p) != 0) return -1;
+    lv->bitmap[priority / WORD_BITS] |= 1UL << (priority % WORD_BITS);
+    return 0;
 }
 
-void execute_processes(queue* queues, int nbPriority, int* currTime, int nxtTime, list* result, int cpu_usage_limit){
-    if (queues == NULL || currTime == NULL || result == NULL) return;
-    
-    while (*currTime < nxtTime){
-        int priority = get_higher_priority(queues, nbPriority);
-
-        if (priority == -1)
-            break;
-
-        process* curr = front(queues[priority]);
-        if (curr == NULL) break;
-        
-        int exec_time = min(nxtTime - *currTime, curr->rem_time);
-        if (exec_time <= 0) break;
-
-        
-        int offset = curr->exec_time - curr->rem_time;
-        
-        int evt_cnt = 0;
-        event* ev_list = getEvents(*curr, offset, offset + exec_time, &evt_cnt);
-
-        for (int i = 0; i < evt_cnt; i++) {
-            ev_list[i].t = *currTime + (ev_list[i].t - offset);
-        }
+static void clear_if_empty(levels* lv, int priority){
+    if (heap_size(lv->queues[priority]) == 0)
+        lv->bitmap[priority / WORD_BITS] &= ~(1UL << (priority % WORD_BITS));
+}
 
-        execute* exec = (execute*)malloc(sizeof(execute));
-        if (exec == NULL) {
-            if (ev_list != NULL) free(ev_list);
-            break;
-        }
-        
-        exec->p = curr;
-        exec->ts = *currTime;
-        exec->te = *currTime + exec_time;
-        exec->event_count = evt_cnt;
-        exec->events = ev_list;
-
-       
-        node* lst = result->tail;
-        bool merged = false;
-        
-        if (lst != NULL && lst->data != NULL) {
-            execute* last_exec = (execute*)lst->data;
-            if (last_exec->p != NULL && last_exec->p->pid == exec->p->pid && last_exec->te == exec->ts){
-             
-                last_exec->te = exec->te;
-                
-               
-                if (evt_cnt > 0 && ev_list != NULL) {
-                    int new_total = last_exec->event_count + evt_cnt;
-                    event* new_events = (event*)realloc(last_exec->events, new_total * sizeof(event));
-                    if (new_events != NULL) {
-                        last_exec->events = new_events;
-                        for (int i = 0; i < evt_cnt; i++) {
-                            last_exec->events[last_exec->event_count + i] = ev_list[i];
-                        }
-                        last_exec->event_count = new_total;
-                    }
-                    free(ev_list);
-                }
-                free(exec);
-                merged = true;
-            }
-        }
-        
-        if (!merged) {
-            add_tail(result, exec);
-            curr->cpu_usage++;
-        }
-        curr->rem_time -= exec_time;
-
-        if (curr->rem_time > 0){
-            if (curr->cpu_usage >= cpu_usage_limit && priority > 0){
-                queues[priority] = pop(queues[priority]);
-                add_to_queue(&queues[priority - 1], curr);
-                curr->cpu_usage = 0;
-            }
-       
-        }
-        else{
-         
-            queues[priority] = pop(queues[priority]);
-        }
+static void pop_from_queue(levels* lv, int priority){
+    heap_pop(lv->queues[priority]);
+    clear_if_empty(lv, priority);
+}
+
+static int get_higher_priority(levels* lv){
+    if (lv == NULL) return -1;
 
-        *currTime += exec_time;
+    for (int w = (lv->nbPriority - 1) / WORD_BITS; w >= 0; w--){
+        if (lv->bitmap[w])
+            return w * WORD_BITS + (WORD_BITS - 1 - __builtin_clzl(lv->bitmap[w]));
     }
+    return -1;
 }
 
-execute* multilevel_scheduler(process* processes, int n, int nbPriority, int *out_cnt, int cpu_usage_limit){
-    if (processes == NULL || n <= 0 || nbPriority <= 0 || out_cnt == NULL) {
-        if (out_cnt != NULL) *out_cnt = 0;
+typedef struct ml_state{
+    levels* lv;
+    int cpu_usage_limit;
+    int level;
+} ml_state;
+
+static void* ml_create(const sim_params* params, arena* a){
+    if (params->nb_priority <= 0) return NULL;
+
+    ml_state* st = (ml_state*)arena_alloc(a, sizeof(ml_state));
+    if (st == NULL) return NULL;
+    st->lv = create_levels(a, params->nb_priority);
+    if (st->lv == NULL)
         return NULL;
-    }
+    st->cpu_usage_limit = params->cpu_usage_limit;
+    st->level = -1;
+    return st;
+}
+
+static int ml_enqueue(void* st, process* p){
+    ml_state* ml = (ml_state*)st;
+    if (p->priority >= 0 && p->priority < ml->lv->nbPriority)
+        return add_to_queue(ml->lv, p->priority, p);
+    return 1;
+}
 
-    queue* queues = (queue*)malloc(nbPriority * sizeof(queue));
-    if (queues == NULL) {
-        *out_cnt = 0;
+// The running process stays at the top of its level until it finishes or is demoted.
+static process* ml_pick_next(void* st){
+    ml_state* ml = (ml_state*)st;
+    ml->level = get_higher_priority(ml->lv);
+    if (ml->level == -1)
         return NULL;
+    return heap_top(ml->lv->queues[ml->level]);
+}
+
+static void ml_on_tick(void* st, process* curr, int ran, int new_slice){
+    (void)ran;
+    ml_state* ml = (ml_state*)st;
+    int priority = ml->level;
+
+    if (new_slice)
+        curr->cpu_usage++;
+
+    if (curr->rem_time > 0){
+        // A demotion that cannot be queued is tried again on the next tick.
+        if (curr->cpu_usage >= ml->cpu_usage_limit && priority > 0 &&
+            add_to_queue(ml->lv, priority - 1, curr) == 0){
+            pop_from_queue(ml->lv, priority);
+            curr->cpu_usage = 0;
+            STATS_INC(demotions);
+        }
     }
-    
-    for (int i = 0; i < nbPriority; i++)
-        queues[i] = create_queue();
-
-    list* result = create_list();
-    if (result == NULL) {
-        free(queues);
-        *out_cnt = 0;
-        return NULL;
+    else{
+        pop_from_queue(ml->lv, priority);
     }
+}
 
-    qsort(processes, n, sizeof(process), compare_process);
-
-    int currTime = 0;
-    for (int i = 0; i < n; i++){
-        int j = i;
-       
-        while (j < n && processes[j].arrival == currTime){
-         
-            if (processes[j].priority >= 0 && processes[j].priority < nbPriority) {
-                add_to_queue(&queues[processes[j].priority], &processes[j]);
-            }
-            j++;
-        }
-        
-     
-        int nxtTime = (j < n) ? processes[j].arrival : 1000000000;
-        execute_processes(queues, nbPriority, &currTime, nxtTime, result, cpu_usage_limit);
+// Every segment ends at the next arrival; the highest ready level is re-evaluated there.
+static int ml_preempt(void* st, process* p, int expired){
+    (void)st;
+    (void)p;
+    (void)expired;
+    return 1;
+}
 
-        if (j < n && currTime < processes[j].arrival) {
-            currTime = processes[j].arrival;
+// Takes a waiting process from the highest level that has one and keeps its level.
+// The running process sits at the top of its heap, so a leaf is never it.
+static process* ml_steal(void* victim, void* thief, process* running){
+    ml_state* from = (ml_state*)victim;
+    ml_state* to = (ml_state*)thief;
+
+    for (int level = from->lv->nbPriority - 1; level >= 0; level--){
+        heap* q = from->lv->queues[level];
+        if (heap_size(q) == 0 || (heap_size(q) == 1 && heap_top(q) == running))
+            continue;
+
+        // Taking the last leaf leaves room to put it back if the thief cannot hold it.
+        process* p = heap_take_last(q);
+        if (add_to_queue(to->lv, level, p) != 0){
+            heap_push(q, p);
+            return NULL;
         }
-        
-        i = j - 1;
+        clear_if_empty(from->lv, level);
+        return p;
     }
-    
-   
-    execute_processes(queues, nbPriority, &currTime, 1000000000, result, cpu_usage_limit);
+    return NULL;
+}
 
-    *out_cnt = getsz(result);
-    if (*out_cnt == 0) {
-        free(queues);
-        return NULL;
-    }
-    
-    execute* output = (execute*)malloc(*out_cnt * sizeof(execute));
-    if (output == NULL) {
-        free(queues);
-        *out_cnt = 0;
-        return NULL;
-    }
-    
-    node* curr = result->head;
-    for (int i = 0; i < *out_cnt; i++) {
-        if (curr == NULL || curr->data == NULL) break;
-        output[i] = *(execute*)curr->data;
-        curr = curr->suiv;
-    }
+const policy multilevel_policy = {
+    .name = "Multilevel",
+    .params = (const char* const[]){ "nb_priority", "cpu_usage_limit", NULL },
+    .preemptive = 1,
+    .coalesce = 1,
+    .create = ml_create,
+    .enqueue = ml_enqueue,
+    .pick_next = ml_pick_next,
+    .on_tick = ml_on_tick,
+    .preempt = ml_preempt,
+    .steal = ml_steal,
+};
 
-    free(queues);
-    return output;
-}
\ No newline at end of file
+execute* multilevel_scheduler(process* processes, int n, int nbPriority, int *out_cnt, int cpu_usage_limit){
+    sim_params params = { .nb_priority = nbPriority, .cpu_usage_limit = cpu_usage_limit };
+    return simulate(&multilevel_policy, processes, n, &params, out_cnt);
+}
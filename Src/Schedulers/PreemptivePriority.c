@@ -1,73 +1,55 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <stdbool.h>
-#include <string.h>
-#include "../../Include/Utils.h"
+#include "../../Include/Scheduler.h"
+#include "../../Include/Heap.h"
+
+static void* pp_create(const sim_params* params, arena* a) {
+    (void)params;
+    return create_heap_in(a, compare_by_priority);
+}
+
+static int pp_enqueue(void* st, process* p) {
+    return p->rem_time > 0 ? heap_push(st, p) : 1;
+}
+
+static process* pp_pick_next(void* st) {
+    process* p = heap_top(st);
+    heap_pop(st);
+    return p;
+}
+
+// Only a strictly higher priority arrival takes the CPU away.
+static int pp_preempt(void* st, process* p, int expired) {
+    (void)expired;
+    process* best = heap_top(st);
+    if(best == NULL || best->priority <= p->priority)
+        return 0;
+    return heap_push(st, p) == 0 ? 1 : -1;
+}
+
+// The running process is not in the heap, so the best waiting one can move.
+// It only leaves the victim once the thief holds it.
+static process* pp_steal(void* victim, void* thief, process* running) {
+    (void)running;
+    process* p = heap_top(victim);
+    if(p == NULL || heap_push(thief, p) != 0)
+        return NULL;
+    heap_pop(victim);
+    return p;
+}
+
+const policy pp_policy = {
+    .name = "PreemptivePriority",
+    .params = (const char* const[]){ NULL },
+    .preemptive = 1,
+    .create = pp_create,
+    .enqueue = pp_enqueue,
+    .pick_next = pp_pick_next,
+    .preempt = pp_preempt,
+    .steal = pp_steal,
+};
 
 execute* pp_scheduler(process* processes, int n, int *out_cnt) {
-    qsort(processes, n, sizeof(process), compare_process); 
-    
-    int currTime = 0;
-    int completed = 0;
-    int sz = 0;
-    execute* result = NULL;
-    
-    while(completed < n) {
-        int idx = -1;
-        int mxPriority = -__INT_MAX__;
-        
-        for(int i = 0; i < n; i++) {
-            if(processes[i].rem_time > 0 && processes[i].arrival <= currTime && processes[i].priority > mxPriority) {
-                idx = i;
-                mxPriority = processes[i].priority;
-            }
-        }
-        
-        if(idx == -1) {
-            for(int i = 0; i < n; i++) {
-                if(processes[i].rem_time > 0) {
-                    currTime = processes[i].arrival;
-                    break;
-                }
-            }
-            continue;
-        }
-        
-        int run_time = processes[idx].rem_time;
-        int next_preemption = currTime + run_time;
-        
-        for(int i = 0; i < n; i++) {
-            if(processes[i].rem_time > 0 && 
-               processes[i].arrival > currTime && 
-               processes[i].arrival < next_preemption &&
-               processes[i].priority > mxPriority) {
-                next_preemption = processes[i].arrival;
-                run_time = next_preemption - currTime;
-            }
-        }
-        int ts = currTime;
-        int te = currTime + run_time;
-        int offset = processes[idx].exec_time - processes[idx].rem_time;
-        int cnte;
-        event* current_events = getEvents(processes[idx], offset, offset + run_time, &cnte);
-        
-        for (int i = 0; i < cnte; i++) {
-            current_events[i].t = ts + (current_events[i].t - offset);
-        }
-        
-        sz++;
-        result = realloc(result, sz * sizeof(execute));
-        result[sz-1] = *make_execute(&processes[idx], ts, te, cnte, current_events);
-        
-     
-        processes[idx].rem_time -= run_time;
-        currTime = te;
-        
-        if(processes[idx].rem_time == 0) {
-            completed++;
-        }
-    }
-    
-    *out_cnt = sz;
-    return result;
-}
\ No newline at end of file
+    sim_params params = {0};
+    return simulate(&pp_policy, processes, n, &params, out_cnt);
+}
@@ -3,74 +3,69 @@
 #include "../../Include/Scheduler.h"
 #include "../../Include/Queue.h"
 
-execute* rr_scheduler(process* processes, int n, int Q, int* out_count) {
-    qsort(processes, n, sizeof(process), compare_process);
-
-    queue q = create_queue();
-
-    int run_time;
-    int now = 0;
-    int index = 0;
-
-    int capacity = 4;
-    int count = 0;
-    execute* result = malloc(sizeof(execute) * capacity);
-
-    while (index < n || size(q) > 0) {
-
-        while (index < n && processes[index].arrival <= now) {
-            push(q, &processes[index]);
-            index++;
-        }
-
-        if (size(q) == 0) {
-            now = processes[index].arrival;
-            continue;
-        }
-
-        process* p = front(q);
-        pop(q);
-
-        int remain = p->rem_time;
+typedef struct rr_state {
+    queue q;
+    int quantum;
+} rr_state;
+
+static void* rr_create(const sim_params* params, arena* a) {
+    rr_state* st = arena_alloc(a, sizeof(rr_state));
+    if (!st) return NULL;
+    st->q = create_queue_in(a);
+    st->quantum = params->quantum > 0 ? params->quantum : 1;
+    return st;
+}
+
+static int rr_enqueue(void* st, process* p) {
+    return push(((rr_state*)st)->q, p) ? 0 : -1;
+}
+
+static process* rr_pick_next(void* st) {
+    queue q = ((rr_state*)st)->q;
+    if (size(q) == 0)
+        return NULL;
+    process* p = front(q);
+    pop(q);
+    return p;
+}
+
+static int rr_time_slice(void* st, process* p) {
+    (void)p;
+    return ((rr_state*)st)->quantum;
+}
+
+// Processes that arrived during the quantum are already queued ahead of p.
+static int rr_preempt(void* st, process* p, int expired) {
+    if (!expired)
+        return 0;
+    return push(((rr_state*)st)->q, p) ? 1 : -1;
+}
+
+// It only leaves the victim once the thief holds it.
+static process* rr_steal(void* victim, void* thief, process* running) {
+    (void)running;
+    queue q = ((rr_state*)victim)->q;
+    if (size(q) == 0)
+        return NULL;
+    process* p = get_tail(q);
+    if (!push(((rr_state*)thief)->q, p))
+        return NULL;
+    del_tail(q);
+    return p;
+}
+
+const policy rr_policy = {
+    .name = "RoundRobin",
+    .params = (const char* const[]){ "quantum", NULL },
+    .create = rr_create,
+    .enqueue = rr_enqueue,
+    .pick_next = rr_pick_next,
+    .time_slice = rr_time_slice,
+    .preempt = rr_preempt,
+    .steal = rr_steal,
+};
 
-        if(remain > Q)
-            run_time = Q;
-        else
-            run_time = remain;
-
-        int ts = now;
-        int te = now + run_time;
-
-        int offset = p->exec_time - p->rem_time;
-        
-p->rem_time -= run_time; 
-        int cnte;
-        event* current_events = getEvents(*p, offset, offset + run_time, &cnte);
-        
-    
-        for (int i = 0; i < cnte; i++) {
-            current_events[i].t = ts + (current_events[i].t - offset);
-        }
-
-        if (count == capacity) {
-            capacity *= 2;
-            result = realloc(result, sizeof(execute) * capacity);
-        }
-        result[count] = *make_execute(p, ts, te, cnte, current_events);
-        count++;
-
-        now = te;
-
-        while (index < n && processes[index].arrival <= now) {
-            push(q, &processes[index]);
-            index++;
-        }
-
-        if (p->rem_time > 0) {
-            push(q, p);
-        }
-    }
-
-    *out_count = count;
-    return result;
-}
\ No newline at end of file
+execute* rr_scheduler(process* processes, int n, int Q, int* out_count) {
+    sim_params params = { .quantum = Q };
+    return simulate(&rr_policy, processes, n, &params, out_count);
+}
@@ -0,0 +1,152 @@
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <zlib.h>
+#include "../../Include/Compression.h"
+
+#define COMPRESS_INPUT_SIZE (64 * 1024)
+
+struct Compressor {
+    z_stream z;
+    int finishing;
+    int done;
+    char input[COMPRESS_INPUT_SIZE];
+};
+
+static int compression_level = Z_DEFAULT_COMPRESSION;
+static size_t compression_min_size = 1024;
+
+void CompressionInit(int level, size_t min_size) {
+    compression_level = level > 9 ? 9 : level;
+    compression_min_size = min_size;
+}
+
+size_t CompressionMinSize(void) {
+    return compression_min_size;
+}
+
+const char* EncodingName(ContentEncoding encoding) {
+    switch (encoding) {
+        case ENCODING_GZIP: return "gzip";
+        case ENCODING_DEFLATE: return "deflate";
+        default: return "identity";
+    }
+}
+
+// Picks the coding with the highest q value, gzip on ties; "*" stands for
+// gzip. Codings with q=0 are refused.
+ContentEncoding NegotiateEncoding(const char *accept_encoding) {
+    ContentEncoding best = ENCODING_IDENTITY;
+    double best_q = 0;
+
+    if (compression_level == 0 || !accept_encoding) return ENCODING_IDENTITY;
+
+    const char *p = accept_encoding;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ',') p++;
+        const char *name = p;
+        while (*p && *p != ',' && *p != ';' && *p != ' ' && *p != '\t') p++;
+        size_t len = p - name;
+
+        double q = 1;
+        const char *end = strchr(p, ',');
+        if (!end) end = p + strlen(p);
+        const char *param = strstr(p, "q=");
+        if (param && param < end) q = strtod(param + 2, NULL);
+        p = end;
+
+        ContentEncoding encoding = ENCODING_IDENTITY;
+        if ((len == 4 && strncasecmp(name, "gzip", 4) == 0) ||
+            (len == 6 && strncasecmp(name, "x-gzip", 6) == 0) ||
+            (len == 1 && *name == '*')) {
+            encoding = ENCODING_GZIP;
+        } else if (len == 7 && strncasecmp(name, "deflate", 7) == 0) {
+            encoding = ENCODING_DEFLATE;
+        }
+        if (encoding == ENCODING_IDENTITY || q <= 0) continue;
+        if (q > best_q || (q == best_q && encoding == ENCODING_GZIP)) {
+            best = encoding;
+            best_q = q;
+        }
+    }
+    return best;
+}
+
+// gzip wraps the deflate data in a gzip header, deflate in a zlib one.
+static int StartDeflate(z_stream *z, ContentEncoding encoding) {
+    memset(z, 0, sizeof(*z));
+    int window_bits = encoding == ENCODING_GZIP ? 15 + 16 : 15;
+    return deflateInit2(z, compression_level, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) == Z_OK ? 0 : -1;
+}
+
+char* CompressBuffer(const char *data, size_t size, ContentEncoding encoding, size_t *compressed_size) {
+    z_stream z;
+
+    if (encoding == ENCODING_IDENTITY || StartDeflate(&z, encoding) != 0) return NULL;
+
+    size_t bound = deflateBound(&z, size);
+    char *out = malloc(bound);
+    if (!out) {
+        deflateEnd(&z);
+        return NULL;
+    }
+
+    z.next_in = (Bytef *)data;
+    z.avail_in = size;
+    z.next_out = (Bytef *)out;
+    z.avail_out = bound;
+    int rc = deflate(&z, Z_FINISH);
+    *compressed_size = z.total_out;
+    deflateEnd(&z);
+
+    if (rc != Z_STREAM_END || *compressed_size >= size) {
+        free(out);
+        return NULL;
+    }
+    return out;
+}
+
+Compressor* CreateCompressor(ContentEncoding encoding) {
+    if (encoding == ENCODING_IDENTITY) return NULL;
+
+    Compressor *c = malloc(sizeof(Compressor));
+    if (!c) return NULL;
+    if (StartDeflate(&c->z, encoding) != 0) {
+        free(c);
+        return NULL;
+    }
+    c->finishing = 0;
+    c->done = 0;
+    return c;
+}
+
+// Keeps deflating until some output is ready, so a 0 return only ever
+// means the end of the compressed stream.
+ssize_t CompressorRead(Compressor *c, CompressorSource source, void *cls, char *out, size_t max) {
+    if (c->done) return 0;
+
+    c->z.next_out = (Bytef *)out;
+    c->z.avail_out = max;
+    while (c->z.avail_out == max) {
+        if (c->z.avail_in == 0 && !c->finishing) {
+            ssize_t n = source(cls, c->input, sizeof(c->input));
+            if (n < 0) return -1;
+            if (n == 0) c->finishing = 1;
+            c->z.next_in = (Bytef *)c->input;
+            c->z.avail_in = n;
+        }
+        int rc = deflate(&c->z, c->finishing ? Z_FINISH : Z_NO_FLUSH);
+        if (rc == Z_STREAM_END) {
+            c->done = 1;
+            break;
+        }
+        if (rc != Z_OK && rc != Z_BUF_ERROR) return -1;
+    }
+    return max - c->z.avail_out;
+}
+
+void FreeCompressor(Compressor *c) {
+    if (!c) return;
+    deflateEnd(&c->z);
+    free(c);
+}
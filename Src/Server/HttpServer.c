@@ -3,12 +3,21 @@
 #include <microhttpd.h>
 #include "../../Include/HttpServer.h"
 #include "../../Include/RequestHandler.h"
+#include "../../Include/ResponseCache.h"
+#include "../../Include/JobQueue.h"
+#include "../../Include/Compression.h"
 
 #define PORT 8080
-#define THREAD_POOL_SIZE 4
 
-int StartHttpServer(void) {
+int StartHttpServer(const ServerOptions *options) {
     struct MHD_Daemon *daemon;
+
+    ResponseCacheInit(options->cache_bytes);
+    CompressionInit(options->compression_level, options->compression_min_size);
+    if (JobQueueStart(options->job_workers, options->job_queue_size, options->run_store_bytes) != 0) {
+        fprintf(stderr, "Failed to start %d job workers\n", options->job_workers);
+        return 1;
+    }
     
     printf("Starting HTTP server on port %d...\n", PORT);
     
@@ -18,12 +27,13 @@ int StartHttpServer(void) {
         NULL, NULL,
         &HandleRequest, NULL,
         MHD_OPTION_NOTIFY_COMPLETED, RequestCompleted, NULL,
-        MHD_OPTION_THREAD_POOL_SIZE, THREAD_POOL_SIZE,
+        MHD_OPTION_THREAD_POOL_SIZE, (unsigned int)options->http_threads,
         MHD_OPTION_END
     );
     
     if (!daemon) {
         fprintf(stderr, "Failed to start server on port %d\n", PORT);
+        JobQueueStop();
         return 1;
     }
     
@@ -33,6 +43,7 @@ int StartHttpServer(void) {
     
     printf("Shutting down server...\n");
     MHD_stop_daemon(daemon);
+    JobQueueStop();
     
     printf("Server stopped.\n");
     
@@ -0,0 +1,411 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../../Include/JobQueue.h"
+
+#define MAX_FINISHED_JOBS 256
+
+typedef struct Job {
+    unsigned long id;
+    JobState state;
+    int cancel;
+    ScheduleRequest req;
+    char *result;
+    trace *slices;
+    lod_pyramid *lod;
+    struct Job *newer;
+    struct Job *older;
+    struct Job *next_queued;
+} Job;
+
+static pthread_mutex_t jobs_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_available = PTHREAD_COND_INITIALIZER;
+static pthread_t *workers;
+static int nb_workers;
+static int stopping;
+
+// Every known job, newest first; the queue threads through the queued ones.
+static Job *newest;
+static Job *oldest;
+static Job *queue_head;
+static Job *queue_tail;
+static int nb_queued;
+static int nb_running;
+static int queue_capacity;
+static int nb_finished;
+static unsigned long next_id = 1;
+static size_t run_store_budget;
+static size_t run_store_used;
+
+const char* JobStateName(JobState state) {
+    switch (state) {
+        case JOB_QUEUED: return "queued";
+        case JOB_RUNNING: return "running";
+        case JOB_DONE: return "done";
+        case JOB_FAILED: return "failed";
+        default: return "cancelled";
+    }
+}
+
+static int IsFinished(const Job *job) {
+    return job->state == JOB_DONE || job->state == JOB_FAILED || job->state == JOB_CANCELLED;
+}
+
+// The table never holds more than capacity + workers + MAX_FINISHED_JOBS
+// jobs, so a scan is cheap next to a simulation.
+static Job* FindJob(unsigned long id) {
+    for (Job *job = newest; job; job = job->older) {
+        if (job->id == id) return job;
+    }
+    return NULL;
+}
+
+static void DropSlices(Job *job) {
+    if (!job->slices) return;
+    run_store_used -= trace_bytes(job->slices) + lod_bytes(job->lod);
+    trace_free(job->slices);
+    lod_free(job->lod);
+    job->slices = NULL;
+    job->lod = NULL;
+}
+
+// Keeps a finished run's slices, dropping the oldest runs' until they fit.
+static void KeepSlices(Job *job, trace *slices, lod_pyramid *lod) {
+    job->slices = slices;
+    job->lod = lod;
+    run_store_used += trace_bytes(slices) + lod_bytes(lod);
+    for (Job *old = oldest; old && run_store_used > run_store_budget; old = old->newer)
+        DropSlices(old);
+}
+
+static void RemoveJob(Job *job) {
+    if (job->newer) job->newer->older = job->older;
+    else newest = job->older;
+    if (job->older) job->older->newer = job->newer;
+    else oldest = job->newer;
+    DropSlices(job);
+    free(job->result);
+    free(job);
+}
+
+static void Finish(Job *job, JobState state) {
+    job->state = state;
+    nb_finished++;
+    for (Job *old = oldest; old && nb_finished > MAX_FINISHED_JOBS; ) {
+        Job *newer = old->newer;
+        if (IsFinished(old)) {
+            RemoveJob(old);
+            nb_finished--;
+        }
+        old = newer;
+    }
+}
+
+static Job* PopQueued(void) {
+    Job *job = queue_head;
+    if (job) {
+        queue_head = job->next_queued;
+        if (!queue_head) queue_tail = NULL;
+        job->next_queued = NULL;
+        nb_queued--;
+    }
+    return job;
+}
+
+static void* Worker(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&jobs_lock);
+    while (1) {
+        while (!stopping && !queue_head)
+            pthread_cond_wait(&work_available, &jobs_lock);
+        if (stopping) break;
+
+        Job *job = PopQueued();
+        job->state = JOB_RUNNING;
+        nb_running++;
+        pthread_mutex_unlock(&jobs_lock);
+
+        // No single run may hold more than the whole store.
+        trace *slices = run_store_budget > 0 ?
+            trace_create(job->req.params.cpus, run_store_budget) : NULL;
+        int failed;
+        char *result = RunSchedulerCancellable(&job->req, &job->cancel, slices, &failed);
+        FreeScheduleRequest(&job->req);
+        lod_pyramid *lod = slices && !failed && result && !slices->truncated ? lod_build(slices) : NULL;
+        if (slices && !lod) {
+            trace_free(slices);
+            slices = NULL;
+        }
+
+        pthread_mutex_lock(&jobs_lock);
+        job->result = result;
+        nb_running--;
+        if (slices) KeepSlices(job, slices, lod);
+        if (!failed && result) Finish(job, JOB_DONE);
+        else if (__atomic_load_n(&job->cancel, __ATOMIC_RELAXED)) Finish(job, JOB_CANCELLED);
+        else Finish(job, JOB_FAILED);
+    }
+    pthread_mutex_unlock(&jobs_lock);
+    return NULL;
+}
+
+int JobQueueStart(int workers_count, int capacity, size_t run_store_bytes) {
+    workers = calloc(workers_count, sizeof(pthread_t));
+    if (!workers) return -1;
+
+    queue_capacity = capacity;
+    run_store_budget = run_store_bytes;
+    stopping = 0;
+    for (nb_workers = 0; nb_workers < workers_count; nb_workers++) {
+        if (pthread_create(&workers[nb_workers], NULL, Worker, NULL) != 0) {
+            JobQueueStop();
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void JobQueueStop(void) {
+    pthread_mutex_lock(&jobs_lock);
+    stopping = 1;
+    for (Job *job = newest; job; job = job->older) {
+        __atomic_store_n(&job->cancel, 1, __ATOMIC_RELAXED);
+    }
+    pthread_cond_broadcast(&work_available);
+    pthread_mutex_unlock(&jobs_lock);
+
+    for (int i = 0; i < nb_workers; i++)
+        pthread_join(workers[i], NULL);
+    free(workers);
+    workers = NULL;
+    nb_workers = 0;
+
+    while (newest) {
+        if (newest->state == JOB_QUEUED)
+            FreeScheduleRequest(&newest->req);
+        RemoveJob(newest);
+    }
+    queue_head = queue_tail = NULL;
+    nb_queued = 0;
+    nb_finished = 0;
+}
+
+int SubmitJob(ScheduleRequest *req, unsigned long *id) {
+    Job *job = calloc(1, sizeof(Job));
+    if (!job) return -1;
+
+    pthread_mutex_lock(&jobs_lock);
+    if (stopping || nb_queued >= queue_capacity) {
+        pthread_mutex_unlock(&jobs_lock);
+        free(job);
+        return -1;
+    }
+
+    job->id = next_id++;
+    job->state = JOB_QUEUED;
+    job->req = *req;
+    job->older = newest;
+    if (newest) newest->newer = job;
+    else oldest = job;
+    newest = job;
+
+    if (queue_tail) queue_tail->next_queued = job;
+    else queue_head = job;
+    queue_tail = job;
+    nb_queued++;
+
+    *id = job->id;
+    req->processes = NULL;
+    req->nb_processes = 0;
+    req->comments = NULL;
+    pthread_cond_signal(&work_available);
+    pthread_mutex_unlock(&jobs_lock);
+    return 0;
+}
+
+void JobQueueCounts(int *queued, int *running) {
+    pthread_mutex_lock(&jobs_lock);
+    *queued = nb_queued;
+    *running = nb_running;
+    pthread_mutex_unlock(&jobs_lock);
+}
+
+char* GetJobStatusJson(unsigned long id) {
+    char *status = NULL;
+
+    pthread_mutex_lock(&jobs_lock);
+    Job *job = FindJob(id);
+    if (job) {
+        int position = 0;
+        for (Job *queued = queue_head; queued && queued != job; queued = queued->next_queued)
+            position++;
+
+        status = malloc(128);
+        if (status && job->state == JOB_QUEUED) {
+            snprintf(status, 128, "{\"id\":%lu,\"state\":\"%s\",\"position\":%d}",
+                     job->id, JobStateName(job->state), position);
+        } else if (status && job->slices) {
+            snprintf(status, 128, "{\"id\":%lu,\"state\":\"%s\",\"slices\":%lld}",
+                     job->id, JobStateName(job->state), job->slices->n);
+        } else if (status) {
+            snprintf(status, 128, "{\"id\":%lu,\"state\":\"%s\"}",
+                     job->id, JobStateName(job->state));
+        }
+    }
+    pthread_mutex_unlock(&jobs_lock);
+    return status;
+}
+
+// *result gets a copy of the stored document, NULL for a job cancelled
+// before it ran.
+JobLookup GetJobResult(unsigned long id, char **result, JobState *state) {
+    JobLookup lookup = JOB_NOT_FOUND;
+    *result = NULL;
+
+    pthread_mutex_lock(&jobs_lock);
+    Job *job = FindJob(id);
+    if (job) {
+        *state = job->state;
+        lookup = IsFinished(job) ? JOB_FOUND : JOB_PENDING;
+        if (lookup == JOB_FOUND && job->result)
+            *result = strdup(job->result);
+    }
+    pthread_mutex_unlock(&jobs_lock);
+    return lookup;
+}
+
+// Returns -1 for an unknown job, 1 when it had already finished.
+int CancelJob(unsigned long id) {
+    int ret = 0;
+
+    pthread_mutex_lock(&jobs_lock);
+    Job *job = FindJob(id);
+    if (!job) {
+        ret = -1;
+    } else if (IsFinished(job)) {
+        ret = 1;
+    } else if (job->state == JOB_RUNNING) {
+        __atomic_store_n(&job->cancel, 1, __ATOMIC_RELAXED);
+    } else {
+        Job **link = &queue_head;
+        Job *prev = NULL;
+        while (*link != job) {
+            prev = *link;
+            link = &(*link)->next_queued;
+        }
+        *link = job->next_queued;
+        if (queue_tail == job) queue_tail = prev;
+        nb_queued--;
+        FreeScheduleRequest(&job->req);
+        Finish(job, JOB_CANCELLED);
+    }
+    pthread_mutex_unlock(&jobs_lock);
+    return ret;
+}
+
+static char* RenderSlices(unsigned long id, const trace *t, const SliceWindow *window) {
+    int from = window->has_from ? window->from : t->start;
+    int to = window->has_to ? window->to : t->end;
+    const trace_cursor *after = window->has_after ? &window->after : NULL;
+    
+    // One more than asked says whether there is a next page.
+    trace_slice *page = malloc(((size_t)window->limit + 1) * sizeof(trace_slice));
+    if (!page) return NULL;
+    int n = trace_query(t, from, to, after, page, window->limit + 1);
+    if (n < 0) {
+        free(page);
+        return NULL;
+    }
+    int more = n > window->limit;
+    if (more) n = window->limit;
+    
+    char *json = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&json, &size);
+    if (!out) {
+        free(page);
+        return NULL;
+    }
+    fprintf(out, "{\"id\":%lu,\"start\":%d,\"end\":%d,\"from\":%d,\"to\":%d,\"total\":%lld,\"slices\":[",
+            id, t->start, t->end, from, to, trace_count(t, from, to));
+    for (int i = 0; i < n; i++) {
+        fprintf(out, "%s{\"pid\":%d,\"cpu\":%d,\"ts\":%d,\"te\":%d,\"offset\":%d}", i > 0 ? "," : "",
+                page[i].pid, page[i].cpu, page[i].ts, page[i].te, page[i].offset);
+    }
+    fprintf(out, "]");
+    if (more) fprintf(out, ",\"next\":\"%d:%d\"", page[n - 1].ts, page[n - 1].cpu);
+    fprintf(out, "}");
+    free(page);
+    if (fclose(out) != 0) {
+        free(json);
+        return NULL;
+    }
+    return json;
+}
+
+// The page is rendered under the lock: it costs a few binary searches per CPU
+// plus the slices written, so it never holds the lock for a whole run.
+JobLookup GetRunSlices(unsigned long id, const SliceWindow *window, char **json) {
+    JobLookup lookup = JOB_NOT_FOUND;
+    *json = NULL;
+    
+    pthread_mutex_lock(&jobs_lock);
+    Job *job = FindJob(id);
+    if (job) {
+        lookup = IsFinished(job) ? JOB_FOUND : JOB_PENDING;
+        if (lookup == JOB_FOUND && job->slices)
+            *json = RenderSlices(id, job->slices, window);
+    }
+    pthread_mutex_unlock(&jobs_lock);
+    return lookup;
+}
+
+static char* RenderLod(unsigned long id, const trace *t, const lod_pyramid *lod, const SliceWindow *window, int pixels) {
+    int from = window->has_from ? window->from : t->start;
+    int to = window->has_to ? window->to : t->end;
+    int first, last;
+    int level = lod_level(lod, from, to, pixels, &first, &last);
+    long long width = lod_width(lod, level);
+    
+    char *json = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&json, &size);
+    if (!out) return NULL;
+    fprintf(out, "{\"id\":%lu,\"start\":%d,\"end\":%d,\"from\":%d,\"to\":%d,\"bucket\":%lld,\"cpus\":[",
+            id, t->start, t->end, from, to, width);
+    for (int c = 0; c < lod->nb_cpus; c++) {
+        const lod_bucket *buckets = lod_buckets(lod, c, level);
+        int written = 0;
+        fprintf(out, "%s{\"cpu\":%d,\"buckets\":[", c > 0 ? "," : "", c);
+        for (int i = first; i <= last; i++) {
+            const lod_bucket *b = &buckets[i];
+            if (b->busy == 0 && b->slices == 0 && b->events == 0) continue;
+            if (written++ > 0) fputc(',', out);
+            lod_write_json(out, b, lod->origin + i * width);
+        }
+        fprintf(out, "]}");
+    }
+    fprintf(out, "]}");
+    if (fclose(out) != 0) {
+        free(json);
+        return NULL;
+    }
+    return json;
+}
+
+// At most pixels buckets per CPU, whatever the length of the run.
+JobLookup GetRunLod(unsigned long id, const SliceWindow *window, int pixels, char **json) {
+    JobLookup lookup = JOB_NOT_FOUND;
+    *json = NULL;
+    
+    pthread_mutex_lock(&jobs_lock);
+    Job *job = FindJob(id);
+    if (job) {
+        lookup = IsFinished(job) ? JOB_FOUND : JOB_PENDING;
+        if (lookup == JOB_FOUND && job->lod)
+            *json = RenderLod(id, job->slices, job->lod, window, pixels);
+    }
+    pthread_mutex_unlock(&jobs_lock);
+    return lookup;
+}
@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "../../Include/Metrics.h"
+#include "../../Include/JobQueue.h"
+
+#define MAX_ALGORITHMS 16
+#define ALGORITHM_NAME_SIZE 32
+
+static const char *const endpoint_names[NB_ENDPOINTS] = {
+    "schedule", "jobs", "job", "run", "algorithms", "cache", "metrics", "other"
+};
+
+// Status 0 is a request that ended before a response was queued.
+static const unsigned int statuses[] = { 0, 200, 202, 400, 404, 409, 413, 500, 503 };
+#define NB_STATUSES (sizeof(statuses) / sizeof(statuses[0]) + 1)
+
+// Upper bounds in microseconds; the last bucket is +Inf.
+static const uint64_t bounds[] = {
+    1000, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000
+};
+#define NB_BUCKETS (sizeof(bounds) / sizeof(bounds[0]) + 1)
+
+typedef struct Histogram {
+    uint64_t buckets[NB_BUCKETS];
+    uint64_t sum;
+} Histogram;
+
+// Only the owning thread writes a block; readers may see a count one
+// update behind, never a torn one.
+typedef struct MetricsBlock {
+    uint64_t requests[NB_ENDPOINTS][NB_STATUSES];
+    Histogram latency[NB_ENDPOINTS];
+    uint64_t started;
+    uint64_t finished;
+    uint64_t bytes;
+    Histogram runs[MAX_ALGORITHMS];
+    uint64_t slices[MAX_ALGORITHMS];
+    struct MetricsBlock *next;
+} MetricsBlock;
+
+static __thread MetricsBlock *local_block;
+static MetricsBlock *blocks;
+static pthread_mutex_t blocks_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static char algorithm_names[MAX_ALGORITHMS][ALGORITHM_NAME_SIZE];
+static int nb_algorithms;
+
+#define BUMP(counter, n) __atomic_store_n(&(counter), (counter) + (n), __ATOMIC_RELAXED)
+#define READ(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+
+uint64_t MetricsNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Blocks stay registered after their thread exits so totals never drop.
+static MetricsBlock* LocalBlock(void) {
+    if (!local_block) {
+        MetricsBlock *block = calloc(1, sizeof(MetricsBlock));
+        if (!block) return NULL;
+        pthread_mutex_lock(&blocks_lock);
+        block->next = blocks;
+        blocks = block;
+        pthread_mutex_unlock(&blocks_lock);
+        local_block = block;
+    }
+    return local_block;
+}
+
+static size_t StatusIndex(unsigned int status) {
+    for (size_t i = 0; i < NB_STATUSES - 1; i++) {
+        if (statuses[i] == status) return i;
+    }
+    return NB_STATUSES - 1;
+}
+
+static void Observe(Histogram *h, uint64_t micros) {
+    size_t i = 0;
+    while (i < NB_BUCKETS - 1 && micros > bounds[i]) i++;
+    BUMP(h->buckets[i], 1);
+    BUMP(h->sum, micros);
+}
+
+// Names are only ever appended, and published after they are written.
+static int AlgorithmSlot(const char *algorithm) {
+    int count = __atomic_load_n(&nb_algorithms, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++) {
+        if (strcmp(algorithm_names[i], algorithm) == 0) return i;
+    }
+
+    pthread_mutex_lock(&blocks_lock);
+    int slot = -1;
+    for (int i = 0; i < nb_algorithms && slot < 0; i++) {
+        if (strcmp(algorithm_names[i], algorithm) == 0) slot = i;
+    }
+    if (slot < 0 && nb_algorithms < MAX_ALGORITHMS) {
+        slot = nb_algorithms;
+        snprintf(algorithm_names[slot], ALGORITHM_NAME_SIZE, "%s", algorithm);
+        __atomic_store_n(&nb_algorithms, slot + 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&blocks_lock);
+    return slot;
+}
+
+void MetricsRequestStarted(void) {
+    MetricsBlock *block = LocalBlock();
+    if (block) BUMP(block->started, 1);
+}
+
+void MetricsRequestFinished(MetricsEndpoint endpoint, unsigned int status, uint64_t micros) {
+    MetricsBlock *block = LocalBlock();
+    if (!block) return;
+    BUMP(block->requests[endpoint][StatusIndex(status)], 1);
+    Observe(&block->latency[endpoint], micros);
+    BUMP(block->finished, 1);
+}
+
+void MetricsBytesSent(size_t bytes) {
+    MetricsBlock *block = LocalBlock();
+    if (block) BUMP(block->bytes, bytes);
+}
+
+void MetricsSchedulerRun(const char *algorithm, uint64_t micros, unsigned long slices) {
+    MetricsBlock *block = LocalBlock();
+    int slot = AlgorithmSlot(algorithm);
+    if (!block || slot < 0) return;
+    Observe(&block->runs[slot], micros);
+    BUMP(block->slices[slot], slices);
+}
+
+static void AddHistogram(Histogram *total, Histogram *h) {
+    for (size_t i = 0; i < NB_BUCKETS; i++) total->buckets[i] += READ(h->buckets[i]);
+    total->sum += READ(h->sum);
+}
+
+static void PrintHistogram(FILE *out, const char *name, const char *label, const char *value, const Histogram *h) {
+    uint64_t count = 0;
+    for (size_t i = 0; i < NB_BUCKETS; i++) {
+        count += h->buckets[i];
+        if (i < NB_BUCKETS - 1) {
+            fprintf(out, "%s_bucket{%s=\"%s\",le=\"%g\"} %llu\n", name, label, value,
+                    bounds[i] / 1e6, (unsigned long long)count);
+        } else {
+            fprintf(out, "%s_bucket{%s=\"%s\",le=\"+Inf\"} %llu\n", name, label, value,
+                    (unsigned long long)count);
+        }
+    }
+    fprintf(out, "%s_sum{%s=\"%s\"} %.6f\n", name, label, value, h->sum / 1e6);
+    fprintf(out, "%s_count{%s=\"%s\"} %llu\n", name, label, value, (unsigned long long)count);
+}
+
+char* GetMetricsText(void) {
+    // Summed into a scratch block: one block is too large for the stack.
+    MetricsBlock *total = calloc(1, sizeof(MetricsBlock));
+    if (!total) return NULL;
+
+    pthread_mutex_lock(&blocks_lock);
+    for (MetricsBlock *block = blocks; block; block = block->next) {
+        for (int e = 0; e < NB_ENDPOINTS; e++) {
+            for (size_t s = 0; s < NB_STATUSES; s++)
+                total->requests[e][s] += READ(block->requests[e][s]);
+            AddHistogram(&total->latency[e], &block->latency[e]);
+        }
+        total->started += READ(block->started);
+        total->finished += READ(block->finished);
+        total->bytes += READ(block->bytes);
+        for (int a = 0; a < MAX_ALGORITHMS; a++) {
+            AddHistogram(&total->runs[a], &block->runs[a]);
+            total->slices[a] += READ(block->slices[a]);
+        }
+    }
+    int count = nb_algorithms;
+    pthread_mutex_unlock(&blocks_lock);
+
+    int queued, running;
+    JobQueueCounts(&queued, &running);
+
+    char *text = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&text, &size);
+    if (!out) {
+        free(total);
+        return NULL;
+    }
+
+    fprintf(out, "# HELP scheduler_http_requests_total HTTP requests answered, by endpoint and status code.\n");
+    fprintf(out, "# TYPE scheduler_http_requests_total counter\n");
+    for (int e = 0; e < NB_ENDPOINTS; e++) {
+        for (size_t s = 0; s < NB_STATUSES; s++) {
+            if (total->requests[e][s] == 0) continue;
+            if (s < NB_STATUSES - 1) {
+                fprintf(out, "scheduler_http_requests_total{endpoint=\"%s\",code=\"%u\"} %llu\n",
+                        endpoint_names[e], statuses[s], (unsigned long long)total->requests[e][s]);
+            } else {
+                fprintf(out, "scheduler_http_requests_total{endpoint=\"%s\",code=\"other\"} %llu\n",
+                        endpoint_names[e], (unsigned long long)total->requests[e][s]);
+            }
+        }
+    }
+
+    fprintf(out, "# HELP scheduler_http_request_duration_seconds Time from a request's arrival to the end of its response.\n");
+    fprintf(out, "# TYPE scheduler_http_request_duration_seconds histogram\n");
+    for (int e = 0; e < NB_ENDPOINTS; e++) {
+        PrintHistogram(out, "scheduler_http_request_duration_seconds", "endpoint", endpoint_names[e],
+                       &total->latency[e]);
+    }
+
+    fprintf(out, "# HELP scheduler_http_requests_in_flight Requests received and not yet answered.\n");
+    fprintf(out, "# TYPE scheduler_http_requests_in_flight gauge\n");
+    fprintf(out, "scheduler_http_requests_in_flight %llu\n",
+            (unsigned long long)(total->started > total->finished ? total->started - total->finished : 0));
+
+    fprintf(out, "# HELP scheduler_http_response_body_bytes_total Response body bytes handed to the network.\n");
+    fprintf(out, "# TYPE scheduler_http_response_body_bytes_total counter\n");
+    fprintf(out, "scheduler_http_response_body_bytes_total %llu\n", (unsigned long long)total->bytes);
+
+    fprintf(out, "# HELP scheduler_run_duration_seconds Time spent simulating and writing a run, by algorithm.\n");
+    fprintf(out, "# TYPE scheduler_run_duration_seconds histogram\n");
+    for (int a = 0; a < count; a++) {
+        PrintHistogram(out, "scheduler_run_duration_seconds", "algorithm", algorithm_names[a], &total->runs[a]);
+    }
+
+    fprintf(out, "# HELP scheduler_slices_total Slices produced by finished runs, by algorithm.\n");
+    fprintf(out, "# TYPE scheduler_slices_total counter\n");
+    for (int a = 0; a < count; a++) {
+        fprintf(out, "scheduler_slices_total{algorithm=\"%s\"} %llu\n", algorithm_names[a],
+                (unsigned long long)total->slices[a]);
+    }
+
+    fprintf(out, "# HELP scheduler_jobs_queued Jobs waiting for a worker.\n");
+    fprintf(out, "# TYPE scheduler_jobs_queued gauge\n");
+    fprintf(out, "scheduler_jobs_queued %d\n", queued);
+    fprintf(out, "# HELP scheduler_jobs_running Jobs being simulated.\n");
+    fprintf(out, "# TYPE scheduler_jobs_running gauge\n");
+    fprintf(out, "scheduler_jobs_running %d\n", running);
+
+    free(total);
+    if (fclose(out) != 0) {
+        free(text);
+        return NULL;
+    }
+    return text;
+}
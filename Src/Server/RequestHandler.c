@@ -1,14 +1,421 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <time.h>
 #include <microhttpd.h>
 #include "../../Include/RequestHandler.h"
 #include "../../Include/ResponseUtils.h"
 #include "../../Include/SchedulerExecutor.h"
+#include "../../Include/ResponseCache.h"
+#include "../../Include/JobQueue.h"
+#include "../../Include/ColumnOutput.h"
+#include "../../Include/Compression.h"
+#include "../../Include/Metrics.h"
 
 #define PORT 8080
 #define MAX_UPLOAD_SIZE (100 * 1024)
+#define JOBS_PREFIX "/api/jobs/"
+#define RUNS_PREFIX "/api/runs/"
+#define DEFAULT_SLICE_LIMIT 1000
+#define MAX_SLICE_LIMIT 10000
+#define DEFAULT_LOD_PIXELS 1000
+#define MAX_LOD_PIXELS 10000
+#define STREAM_BLOCK_SIZE (32 * 1024)
+
+static ContentEncoding AcceptedEncoding(struct MHD_Connection *connection) {
+    return NegotiateEncoding(MHD_lookup_connection_value(connection, MHD_HEADER_KIND,
+                                                         MHD_HTTP_HEADER_ACCEPT_ENCODING));
+}
+
+// Takes ownership of body and compresses it when the client accepts a
+// coding and the body is long enough to be worth it.
+static struct MHD_Response* CreateBodyResponse(struct MHD_Connection *connection, char *body, size_t size) {
+    ContentEncoding encoding = size >= CompressionMinSize() ? AcceptedEncoding(connection) : ENCODING_IDENTITY;
+    size_t compressed_size;
+    char *compressed = CompressBuffer(body, size, encoding, &compressed_size);
+    
+    if (compressed) {
+        free(body);
+        body = compressed;
+        size = compressed_size;
+    }
+    struct MHD_Response *response = MHD_create_response_from_buffer(size, body, MHD_RESPMEM_MUST_FREE);
+    if (!response) {
+        free(body);
+        return NULL;
+    }
+    if (compressed) {
+        MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_ENCODING, EncodingName(encoding));
+    }
+    MHD_add_response_header(response, MHD_HTTP_HEADER_VARY, "Accept-Encoding");
+    MetricsBytesSent(size);
+    return response;
+}
+
+// Queues and releases response, remembering its status for the metrics.
+static enum MHD_Result Respond(struct MHD_Connection *connection, struct ConnectionInfo *con_info,
+                               unsigned int status_code, struct MHD_Response *response) {
+    AddCorsHeaders(response);
+    con_info->status = status_code;
+    enum MHD_Result ret = MHD_queue_response(connection, status_code, response);
+    MHD_destroy_response(response);
+    return ret;
+}
+
+static enum MHD_Result SendJson(struct MHD_Connection *connection, struct ConnectionInfo *con_info,
+                                unsigned int status_code, char *body) {
+    if (!body) return MHD_NO;
+    
+    struct MHD_Response *response = CreateBodyResponse(connection, body, strlen(body));
+    if (!response) return MHD_NO;
+    return Respond(connection, con_info, status_code, response);
+}
+
+typedef struct StreamContext {
+    ScheduleStream *stream;
+    Compressor *compressor;
+    char *head;
+    size_t head_len;
+    size_t head_cap;
+    size_t head_off;
+    CacheTicket *ticket;
+    char *copy;
+    size_t copy_len;
+    size_t copy_cap;
+    size_t copy_limit;
+    int copying;
+} StreamContext;
+
+// Keeps a copy of what was sent for the cache while it stays under the
+// per-entry limit; past it the copy is dropped and the run is not cached.
+static void KeepCopy(StreamContext *ctx, const char *data, size_t size) {
+    if (!ctx->copying) return;
+    if (ctx->copy_len + size > ctx->copy_limit) {
+        free(ctx->copy);
+        ctx->copy = NULL;
+        ctx->copying = 0;
+        return;
+    }
+    if (ctx->copy_len + size >= ctx->copy_cap) {
+        size_t cap = ctx->copy_cap ? ctx->copy_cap * 2 : STREAM_BLOCK_SIZE;
+        while (cap <= ctx->copy_len + size) cap *= 2;
+        char *bigger = realloc(ctx->copy, cap);
+        if (!bigger) {
+            free(ctx->copy);
+            ctx->copy = NULL;
+            ctx->copying = 0;
+            return;
+        }
+        ctx->copy = bigger;
+        ctx->copy_cap = cap;
+    }
+    memcpy(ctx->copy + ctx->copy_len, data, size);
+    ctx->copy_len += size;
+}
+
+// Hands the complete document to the cache.
+static void FinishCopy(StreamContext *ctx) {
+    if (!ctx->ticket) return;
+    int keep = ctx->copying && ctx->copy;
+    if (keep) ctx->copy[ctx->copy_len] = '\0';
+    ResponseCacheFinish(ctx->ticket, keep ? ctx->copy : NULL, ctx->copy_len, keep);
+    ctx->ticket = NULL;
+    ctx->copy = NULL;
+}
+
+// The uncompressed document: whatever was peeked first, then the run.
+static ssize_t ReadPlain(void *cls, char *buf, size_t max) {
+    StreamContext *ctx = cls;
+    
+    if (ctx->head_off < ctx->head_len) {
+        size_t n = ctx->head_len - ctx->head_off < max ? ctx->head_len - ctx->head_off : max;
+        memcpy(buf, ctx->head + ctx->head_off, n);
+        ctx->head_off += n;
+        return n;
+    }
+    return ReadScheduleStream(ctx->stream, buf, max);
+}
+
+// Runs until size bytes are out or the run ends, so that short documents
+// can go out whole. Returns 0 when the run ended within them.
+static int PeekStream(StreamContext *ctx, size_t size) {
+    while (ctx->head_len < size) {
+        if (ctx->head_len == ctx->head_cap) {
+            size_t cap = ctx->head_cap ? ctx->head_cap * 2 : STREAM_BLOCK_SIZE;
+            if (cap > size) cap = size;
+            char *bigger = realloc(ctx->head, cap);
+            if (!bigger) return 1;
+            ctx->head = bigger;
+            ctx->head_cap = cap;
+        }
+        ssize_t n = ReadScheduleStream(ctx->stream, ctx->head + ctx->head_len, ctx->head_cap - ctx->head_len);
+        if (n <= 0) return n < 0;
+        KeepCopy(ctx, ctx->head + ctx->head_len, n);
+        ctx->head_len += n;
+    }
+    return 1;
+}
+
+static ssize_t StreamChunk(void *cls, uint64_t pos, char *buf, size_t max) {
+    StreamContext *ctx = cls;
+    ssize_t n = ctx->compressor ? CompressorRead(ctx->compressor, ReadPlain, ctx, buf, max)
+                                : ReadPlain(ctx, buf, max);
+    
+    if (n < 0) {
+        return MHD_CONTENT_READER_END_WITH_ERROR;
+    }
+    if (n == 0) {
+        return MHD_CONTENT_READER_END_OF_STREAM;
+    }
+    MetricsBytesSent(n);
+    return n;
+}
+
+// Releases the ticket without a document, so that waiting duplicates run on
+// their own, and stops copying.
+static void ReleaseTicket(StreamContext *ctx) {
+    if (ctx->ticket) ResponseCacheFinish(ctx->ticket, NULL, 0, 0);
+    ctx->ticket = NULL;
+    free(ctx->copy);
+    ctx->copy = NULL;
+    ctx->copying = 0;
+}
+
+static void StreamDone(void *cls) {
+    StreamContext *ctx = cls;
+    ReleaseTicket(ctx);
+    free(ctx->head);
+    FreeCompressor(ctx->compressor);
+    CloseScheduleStream(ctx->stream);
+    free(ctx);
+}
+
+// Cached documents go out whole; anything else is streamed with chunked
+// encoding while it runs, compressed on the fly when the client accepts it
+// and the run outgrows the compression threshold. An Accept header naming
+// COLUMNS_MIME selects the columnar binary result.
+//
+// Identical requests wait for a run holding a ticket on their own threads, so
+// that run is rendered here, up to what the cache may keep, and its ticket
+// finished before this handler returns: waiters never depend on this
+// connection's client, nor on this thread being free. A run outgrowing the
+// limit releases its waiters and streams the rest.
+static enum MHD_Result HandleSchedule(struct MHD_Connection *connection, struct ConnectionInfo *con_info) {
+    ScheduleRequest req;
+    char *cached, *error;
+    size_t cached_size;
+    CacheTicket *ticket;
+    
+    if (ParseScheduleRequest(con_info->data, &req) != 0) {
+        return SendJson(connection, con_info, MHD_HTTP_BAD_REQUEST, CreateErrorResponse("Invalid request format"));
+    }
+    const char *accept = MHD_lookup_connection_value(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_ACCEPT);
+    if (accept && strstr(accept, COLUMNS_MIME)) {
+        req.format = FORMAT_COLUMNS;
+    }
+    ScheduleFormat format = req.format;
+    
+    CacheOutcome outcome = ResponseCacheLookup(&req, &cached, &cached_size, &ticket);
+    // A coalesced or cached error document is JSON whatever was asked for.
+    int binary = format == FORMAT_COLUMNS && !(cached && cached_size > 0 && cached[0] == '{');
+    struct MHD_Response *response;
+    if (cached) {
+        FreeScheduleRequest(&req);
+        response = CreateBodyResponse(connection, cached, cached_size);
+        if (!response) return MHD_NO;
+    } else {
+        StreamContext *ctx = calloc(1, sizeof(StreamContext));
+        ScheduleStream *stream = ctx ? OpenScheduleStream(&req, &error) : NULL;
+        if (!stream) {
+            FreeScheduleRequest(&req);
+            free(ctx);
+            if (!ctx) error = CreateErrorResponse("Memory allocation failed");
+            if (ticket) ResponseCacheFinish(ticket, error ? strdup(error) : NULL, error ? strlen(error) : 0, 0);
+            return SendJson(connection, con_info, MHD_HTTP_OK, error);
+        }
+        
+        ctx->stream = stream;
+        ctx->ticket = ticket;
+        ctx->copy_limit = ticket ? ResponseCacheEntryLimit() : 0;
+        ctx->copying = ctx->copy_limit > 0;
+        
+        ContentEncoding encoding = AcceptedEncoding(connection);
+        size_t peek = ticket ? ctx->copy_limit + 1 : encoding != ENCODING_IDENTITY ? CompressionMinSize() : 0;
+        int whole = peek > 0 && PeekStream(ctx, peek) == 0;
+        if (whole) FinishCopy(ctx);
+        else ReleaseTicket(ctx);
+        if (whole) {
+            response = CreateBodyResponse(connection, ctx->head, ctx->head_len);
+            ctx->head = NULL;
+            StreamDone(ctx);
+            if (!response) return MHD_NO;
+        } else {
+            ctx->compressor = CreateCompressor(encoding);
+            response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, STREAM_BLOCK_SIZE,
+                                                         StreamChunk, ctx, StreamDone);
+            if (!response) {
+                StreamDone(ctx);
+                return MHD_NO;
+            }
+            if (ctx->compressor) {
+                MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_ENCODING, EncodingName(encoding));
+            }
+            MHD_add_response_header(response, MHD_HTTP_HEADER_VARY, "Accept-Encoding");
+        }
+    }
+    
+    if (binary) {
+        MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_TYPE, COLUMNS_MIME);
+    }
+    MHD_add_response_header(response, MHD_HTTP_HEADER_VARY, "Accept");
+    MHD_add_response_header(response, "X-Cache", CacheOutcomeName(outcome));
+    MHD_add_response_header(response, "Access-Control-Expose-Headers", "X-Cache");
+    return Respond(connection, con_info, MHD_HTTP_OK, response);
+}
+
+// Queues the decoded request and answers at once with the new job's status.
+static enum MHD_Result SubmitJobRequest(struct MHD_Connection *connection, struct ConnectionInfo *con_info) {
+    ScheduleRequest req;
+    unsigned long id;
+    
+    if (ParseScheduleRequest(con_info->data, &req) != 0) {
+        return SendJson(connection, con_info, MHD_HTTP_BAD_REQUEST, CreateErrorResponse("Invalid request format"));
+    }
+    if (SubmitJob(&req, &id) != 0) {
+        FreeScheduleRequest(&req);
+        return SendJson(connection, con_info, MHD_HTTP_SERVICE_UNAVAILABLE, CreateErrorResponse("Job queue is full"));
+    }
+    // The job is queued whatever happens next, so the client always gets its id.
+    char *status = GetJobStatusJson(id);
+    if (!status && (status = malloc(32)) != NULL) {
+        snprintf(status, 32, "{\"id\":%lu}", id);
+    }
+    return SendJson(connection, con_info, MHD_HTTP_ACCEPTED, status);
+}
+
+// GET /api/jobs/{id}, GET /api/jobs/{id}/result and POST /api/jobs/{id}/cancel.
+static enum MHD_Result HandleJobRequest(struct MHD_Connection *connection, struct ConnectionInfo *con_info,
+                                        const char *method, const char *url) {
+    char *end;
+    unsigned long id = strtoul(url + strlen(JOBS_PREFIX), &end, 10);
+    int is_get = strcmp(method, "GET") == 0;
+    
+    if (end == url + strlen(JOBS_PREFIX)) {
+        return SendJson(connection, con_info, MHD_HTTP_NOT_FOUND, CreateErrorResponse("Endpoint not found"));
+    }
+    
+    if (is_get && *end == '\0') {
+        char *status = GetJobStatusJson(id);
+        if (!status) return SendJson(connection, con_info, MHD_HTTP_NOT_FOUND, CreateErrorResponse("Unknown job"));
+        return SendJson(connection, con_info, MHD_HTTP_OK, status);
+    }
+    
+    if (is_get && strcmp(end, "/result") == 0) {
+        char *result;
+        JobState state;
+        switch (GetJobResult(id, &result, &state)) {
+            case JOB_NOT_FOUND:
+                return SendJson(connection, con_info, MHD_HTTP_NOT_FOUND, CreateErrorResponse("Unknown job"));
+            case JOB_PENDING:
+                return SendJson(connection, con_info, MHD_HTTP_ACCEPTED, GetJobStatusJson(id));
+            default:
+                break;
+        }
+        if (state == JOB_CANCELLED) {
+            free(result);
+            return SendJson(connection, con_info, MHD_HTTP_CONFLICT, CreateErrorResponse("Job cancelled"));
+        }
+        if (!result) return SendJson(connection, con_info, MHD_HTTP_INTERNAL_SERVER_ERROR, CreateErrorResponse("Failed to execute scheduler"));
+        return SendJson(connection, con_info, state == JOB_DONE ? MHD_HTTP_OK : MHD_HTTP_INTERNAL_SERVER_ERROR, result);
+    }
+    
+    if (strcmp(method, "POST") == 0 && strcmp(end, "/cancel") == 0) {
+        if (CancelJob(id) < 0) return SendJson(connection, con_info, MHD_HTTP_NOT_FOUND, CreateErrorResponse("Unknown job"));
+        return SendJson(connection, con_info, MHD_HTTP_OK, GetJobStatusJson(id));
+    }
+    
+    return SendJson(connection, con_info, MHD_HTTP_NOT_FOUND, CreateErrorResponse("Endpoint not found"));
+}
+
+// Integer query argument; missing ones leave *value alone. Returns -1 when malformed.
+static int QueryInt(struct MHD_Connection *connection, const char *key, int *present, int *value) {
+    const char *arg = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, key);
+    if (present) *present = arg != NULL;
+    if (!arg) return 0;
+    
+    char *end;
+    long parsed = strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || parsed < INT_MIN || parsed > INT_MAX) return -1;
+    *value = (int)parsed;
+    return 0;
+}
+
+// from, to and limit, and after as the "ts:cpu" a previous page gave as next.
+// A window given both ends must not be empty.
+static int ParseSliceWindow(struct MHD_Connection *connection, SliceWindow *window) {
+    memset(window, 0, sizeof(*window));
+    window->limit = DEFAULT_SLICE_LIMIT;
+    if (QueryInt(connection, "from", &window->has_from, &window->from) != 0 ||
+        QueryInt(connection, "to", &window->has_to, &window->to) != 0 ||
+        QueryInt(connection, "limit", NULL, &window->limit) != 0 ||
+        window->limit < 1 || window->limit > MAX_SLICE_LIMIT ||
+        (window->has_from && window->has_to && window->from >= window->to)) {
+        return -1;
+    }
+    
+    const char *after = MHD_lookup_connection_value(connection, MHD_GET_ARGUMENT_KIND, "after");
+    if (after) {
+        char tail;
+        if (sscanf(after, "%d:%d%c", &window->after.ts, &window->after.cpu, &tail) != 2) return -1;
+        window->has_after = 1;
+    }
+    return 0;
+}
+
+// GET /api/runs/{id}/slices: a window of a finished job's slices.
+// GET /api/runs/{id}/lod: the same window drawn in at most pixels buckets per CPU.
+static enum MHD_Result HandleRunRequest(struct MHD_Connection *connection, struct ConnectionInfo *con_info,
+                                        const char *method, const char *url) {
+    char *end;
+    unsigned long id = strtoul(url + strlen(RUNS_PREFIX), &end, 10);
+    int lod = strcmp(end, "/lod") == 0;
+    
+    if (end == url + strlen(RUNS_PREFIX) || strcmp(method, "GET") != 0 || (!lod && strcmp(end, "/slices") != 0)) {
+        return SendJson(connection, con_info, MHD_HTTP_NOT_FOUND, CreateErrorResponse("Endpoint not found"));
+    }
+    
+    SliceWindow window;
+    int pixels = DEFAULT_LOD_PIXELS;
+    if (ParseSliceWindow(connection, &window) != 0 ||
+        QueryInt(connection, "pixels", NULL, &pixels) != 0 || pixels < 1 || pixels > MAX_LOD_PIXELS) {
+        return SendJson(connection, con_info, MHD_HTTP_BAD_REQUEST, CreateErrorResponse("Invalid slice window"));
+    }
+    
+    char *page;
+    JobLookup lookup = lod ? GetRunLod(id, &window, pixels, &page) : GetRunSlices(id, &window, &page);
+    switch (lookup) {
+        case JOB_NOT_FOUND:
+            return SendJson(connection, con_info, MHD_HTTP_NOT_FOUND, CreateErrorResponse("Unknown run"));
+        case JOB_PENDING:
+            return SendJson(connection, con_info, MHD_HTTP_ACCEPTED, GetJobStatusJson(id));
+        default:
+            break;
+    }
+    if (!page) return SendJson(connection, con_info, MHD_HTTP_NOT_FOUND, CreateErrorResponse("Run slices not kept"));
+    return SendJson(connection, con_info, MHD_HTTP_OK, page);
+}
+
+static MetricsEndpoint ClassifyEndpoint(const char *url) {
+    if (strcmp(url, "/api/schedule") == 0) return ENDPOINT_SCHEDULE;
+    if (strcmp(url, "/api/jobs") == 0) return ENDPOINT_JOBS;
+    if (strncmp(url, JOBS_PREFIX, strlen(JOBS_PREFIX)) == 0) return ENDPOINT_JOB;
+    if (strncmp(url, RUNS_PREFIX, strlen(RUNS_PREFIX)) == 0) return ENDPOINT_RUN;
+    if (strcmp(url, "/api/algorithms") == 0) return ENDPOINT_ALGORITHMS;
+    if (strcmp(url, "/api/cache") == 0) return ENDPOINT_CACHE;
+    if (strcmp(url, "/api/metrics") == 0) return ENDPOINT_METRICS;
+    return ENDPOINT_OTHER;
+}
 
 enum MHD_Result HandleRequest(
     void *cls,
@@ -20,40 +427,37 @@ enum MHD_Result HandleRequest(
     size_t *upload_data_size,
     void **con_cls
 ) {
-    struct MHD_Response *response;
-    enum MHD_Result ret;
-    int status_code = MHD_HTTP_OK;
-    
-    if (strcmp(method, "OPTIONS") == 0) {
-        response = MHD_create_response_from_buffer(0, "", MHD_RESPMEM_PERSISTENT);
-        AddCorsHeaders(response);
-        ret = MHD_queue_response(connection, MHD_HTTP_OK, response);
-        MHD_destroy_response(response);
-        return ret;
-    }
+    struct ConnectionInfo *con_info = *con_cls;
     
-    if (strcmp(method, "POST") == 0 && strcmp(url, "/api/schedule") == 0) {
-        struct ConnectionInfo *con_info = *con_cls;
+    // Every request gets a ConnectionInfo on its first call so that its
+    // latency and status reach the metrics once it completes.
+    if (!con_info) {
+        con_info = calloc(1, sizeof(struct ConnectionInfo));
+        if (!con_info) return MHD_NO;
         
-        if (!con_info) {
-            con_info = malloc(sizeof(struct ConnectionInfo));
-            if (!con_info) return MHD_NO;
-            
-            con_info->data = NULL;
-            con_info->size = 0;
-            *con_cls = con_info;
+        con_info->start = MetricsNow();
+        con_info->endpoint = ClassifyEndpoint(url);
+        *con_cls = con_info;
+        MetricsRequestStarted();
+        
+        // Wait for the body of uploads.
+        if (strcmp(method, "POST") == 0 &&
+            (con_info->endpoint == ENDPOINT_SCHEDULE || con_info->endpoint == ENDPOINT_JOBS)) {
             return MHD_YES;
         }
-        
+    }
+    
+    if (strcmp(method, "OPTIONS") == 0) {
+        struct MHD_Response *response = MHD_create_response_from_buffer(0, "", MHD_RESPMEM_PERSISTENT);
+        return Respond(connection, con_info, MHD_HTTP_OK, response);
+    }
+    
+    if (strcmp(method, "POST") == 0 &&
+        (con_info->endpoint == ENDPOINT_SCHEDULE || con_info->endpoint == ENDPOINT_JOBS)) {
         if (*upload_data_size > 0) {
             if (con_info->size + *upload_data_size > MAX_UPLOAD_SIZE) {
-                char *error = CreateErrorResponse("Request too large");
-                response = MHD_create_response_from_buffer(strlen(error), error,
-                                                          MHD_RESPMEM_MUST_FREE);
-                AddCorsHeaders(response);
-                ret = MHD_queue_response(connection, MHD_HTTP_REQUEST_ENTITY_TOO_LARGE, response);
-                MHD_destroy_response(response);
-                return ret;
+                return SendJson(connection, con_info, MHD_HTTP_REQUEST_ENTITY_TOO_LARGE,
+                                CreateErrorResponse("Request too large"));
             }
             
             char *new_data = realloc(con_info->data, con_info->size + *upload_data_size + 1);
@@ -68,73 +472,42 @@ enum MHD_Result HandleRequest(
             return MHD_YES;
         }
         
+        if (con_info->data && con_info->endpoint == ENDPOINT_JOBS) {
+            return SubmitJobRequest(connection, con_info);
+        }
+        
         if (con_info->data) {
-            char config_path[256];
-            char algorithm[50];
-            int quantum, cpu_limit, nb_priority;
-            
-            if (CreateConfigFileFromJson(
-                    con_info->data,
-                    config_path, sizeof(config_path),
-                    algorithm, sizeof(algorithm),
-                    &quantum, &cpu_limit, &nb_priority) == 0) {
-                
-                char *json_response = RunSchedulerAndCaptureOutput(
-                    config_path, algorithm, quantum, cpu_limit, nb_priority
-                );
-                
-                if (json_response) {
-                    response = MHD_create_response_from_buffer(
-                        strlen(json_response),
-                        json_response,
-                        MHD_RESPMEM_MUST_FREE
-                    );
-                    status_code = MHD_HTTP_OK;
-                } else {
-                    char *error = CreateErrorResponse("Failed to execute scheduler");
-                    response = MHD_create_response_from_buffer(
-                        strlen(error), error, MHD_RESPMEM_MUST_FREE
-                    );
-                    status_code = MHD_HTTP_INTERNAL_SERVER_ERROR;
-                }
-            } else {
-                char *error = CreateErrorResponse("Invalid request format");
-                response = MHD_create_response_from_buffer(
-                    strlen(error), error, MHD_RESPMEM_MUST_FREE
-                );
-                status_code = MHD_HTTP_BAD_REQUEST;
-            }
-            
-            AddCorsHeaders(response);
-            ret = MHD_queue_response(connection, status_code, response);
-            MHD_destroy_response(response);
-            return ret;
+            return HandleSchedule(connection, con_info);
         }
     }
     
-    if (strcmp(method, "GET") == 0 && strcmp(url, "/api/algorithms") == 0) {
-        char *algorithms_json = GetAlgorithmsJson();
+    if (strcmp(method, "GET") == 0 && con_info->endpoint == ENDPOINT_ALGORITHMS) {
+        return SendJson(connection, con_info, MHD_HTTP_OK, GetAlgorithmsJson());
+    }
+    
+    if (strcmp(method, "GET") == 0 && con_info->endpoint == ENDPOINT_CACHE) {
+        return SendJson(connection, con_info, MHD_HTTP_OK, GetCacheStatsJson());
+    }
+    
+    if (strcmp(method, "GET") == 0 && con_info->endpoint == ENDPOINT_METRICS) {
+        char *metrics = GetMetricsText();
+        if (!metrics) return MHD_NO;
         
-        response = MHD_create_response_from_buffer(
-            strlen(algorithms_json),
-            algorithms_json,
-            MHD_RESPMEM_MUST_FREE
-        );
-        AddCorsHeaders(response);
-        ret = MHD_queue_response(connection, MHD_HTTP_OK, response);
-        MHD_destroy_response(response);
-        return ret;
-    }
-    
-    
-    char *not_found = CreateErrorResponse("Endpoint not found");
-    response = MHD_create_response_from_buffer(
-        strlen(not_found), not_found, MHD_RESPMEM_MUST_FREE
-    );
-    AddCorsHeaders(response);
-    ret = MHD_queue_response(connection, MHD_HTTP_NOT_FOUND, response);
-    MHD_destroy_response(response);
-    return ret;
+        struct MHD_Response *response = CreateBodyResponse(connection, metrics, strlen(metrics));
+        if (!response) return MHD_NO;
+        MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_TYPE, "text/plain; version=0.0.4");
+        return Respond(connection, con_info, MHD_HTTP_OK, response);
+    }
+    
+    if (con_info->endpoint == ENDPOINT_JOB) {
+        return HandleJobRequest(connection, con_info, method, url);
+    }
+    
+    if (con_info->endpoint == ENDPOINT_RUN) {
+        return HandleRunRequest(connection, con_info, method, url);
+    }
+    
+    return SendJson(connection, con_info, MHD_HTTP_NOT_FOUND, CreateErrorResponse("Endpoint not found"));
 }
 
 void RequestCompleted(
@@ -146,6 +519,7 @@ void RequestCompleted(
     struct ConnectionInfo *con_info = *con_cls;
     
     if (con_info) {
+        MetricsRequestFinished(con_info->endpoint, con_info->status, MetricsNow() - con_info->start);
         if (con_info->data) {
             free(con_info->data);
         }
@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "../../Include/ResponseCache.h"
+#include "../../Include/ResponseUtils.h"
+#include "../../Include/Intern.h"
+
+#define NB_BUCKETS 4096
+
+typedef enum EntryState {
+    ENTRY_RUNNING,
+    ENTRY_READY,
+    ENTRY_DROPPED
+} EntryState;
+
+typedef struct CacheEntry CacheEntry;
+
+struct CacheEntry {
+    uint64_t hash;
+    char *key;
+    size_t key_len;
+    char *response;
+    size_t response_len;
+    EntryState state;
+    int waiters;
+    struct CacheEntry *bucket_next;
+    struct CacheEntry *lru_prev;
+    struct CacheEntry *lru_next;
+};
+
+typedef struct KeyBuffer {
+    char *data;
+    size_t len;
+    size_t cap;
+} KeyBuffer;
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cache_done = PTHREAD_COND_INITIALIZER;
+static CacheEntry *buckets[NB_BUCKETS];
+static CacheEntry *lru_head;
+static CacheEntry *lru_tail;
+static size_t budget = 64 * 1024 * 1024;
+static size_t used_bytes;
+static size_t nb_entries;
+static unsigned long hits, misses, coalesced, evictions;
+
+void ResponseCacheInit(size_t budget_bytes) {
+    pthread_mutex_lock(&cache_lock);
+    budget = budget_bytes;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+const char* CacheOutcomeName(CacheOutcome outcome) {
+    switch (outcome) {
+        case CACHE_HIT: return "HIT";
+        case CACHE_COALESCED: return "COALESCED";
+        default: return "MISS";
+    }
+}
+
+static int KeyAppend(KeyBuffer *k, const void *data, size_t size) {
+    if (k->len + size > k->cap) {
+        size_t cap = k->cap ? k->cap * 2 : 256;
+        while (cap < k->len + size) cap *= 2;
+        char *bigger = realloc(k->data, cap);
+        if (!bigger) return -1;
+        k->data = bigger;
+        k->cap = cap;
+    }
+    memcpy(k->data + k->len, data, size);
+    k->len += size;
+    return 0;
+}
+
+static int KeyAppendInt(KeyBuffer *k, int value) {
+    return KeyAppend(k, &value, sizeof(value));
+}
+
+static int ParamValue(const sim_params *params, const char *name) {
+    if (strcmp(name, "quantum") == 0) return params->quantum;
+    if (strcmp(name, "nb_priority") == 0) return params->nb_priority;
+    if (strcmp(name, "cpu_usage_limit") == 0) return params->cpu_usage_limit;
+    return 0;
+}
+
+// Parameters the algorithm ignores are left out, so e.g. a Fifo request hits
+// whatever quantum it carries. Processes keep their order: it decides the pids.
+static char* CanonicalKey(const ScheduleRequest *req, size_t *len) {
+    KeyBuffer k = {0};
+    int err = KeyAppend(&k, req->algorithm, strlen(req->algorithm) + 1);
+
+    const policy *pol = find_policy(req->algorithm);
+    if (pol) {
+        for (const char *const *param = pol->params; *param != NULL; param++)
+            err |= KeyAppendInt(&k, ParamValue(&req->params, *param));
+    }
+    err |= KeyAppendInt(&k, req->params.cpus);
+    err |= KeyAppendInt(&k, req->format);
+    err |= KeyAppendInt(&k, req->metrics);
+    err |= KeyAppendInt(&k, req->detail);
+    if (req->detail == DETAIL_SAMPLED) {
+        err |= KeyAppendInt(&k, req->sample_every);
+        err |= KeyAppendInt(&k, req->sample_size);
+        err |= KeyAppend(&k, &req->sample_seed, sizeof(req->sample_seed));
+    }
+    err |= KeyAppendInt(&k, req->nb_processes);
+
+    for (int i = 0; i < req->nb_processes && !err; i++) {
+        const process *p = &req->processes[i];
+        err |= KeyAppend(&k, p->name, strlen(p->name) + 1);
+        err |= KeyAppendInt(&k, p->arrival);
+        err |= KeyAppendInt(&k, p->exec_time);
+        err |= KeyAppendInt(&k, p->priority);
+        err |= KeyAppendInt(&k, p->nbEvents);
+        for (int j = 0; j < p->nbEvents && !err; j++) {
+            const char *comment = comment_table_text(req->comments, p->events[j].comment_id);
+            err |= KeyAppendInt(&k, p->events[j].t);
+            err |= KeyAppend(&k, comment, strlen(comment) + 1);
+        }
+    }
+
+    if (err) {
+        free(k.data);
+        return NULL;
+    }
+    *len = k.len;
+    return k.data;
+}
+
+static uint64_t HashKey(const char *key, size_t len) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < len; i++)
+        h = (h ^ (unsigned char)key[i]) * 1099511628211ull;
+    return h;
+}
+
+static size_t EntryBytes(const CacheEntry *e) {
+    return sizeof(*e) + e->key_len + e->response_len;
+}
+
+static CacheEntry** FindSlot(uint64_t hash, const char *key, size_t len) {
+    CacheEntry **slot = &buckets[hash % NB_BUCKETS];
+    while (*slot) {
+        CacheEntry *e = *slot;
+        if (e->hash == hash && e->key_len == len && memcmp(e->key, key, len) == 0)
+            break;
+        slot = &e->bucket_next;
+    }
+    return slot;
+}
+
+static void Unlink(CacheEntry *e) {
+    CacheEntry **slot = FindSlot(e->hash, e->key, e->key_len);
+    if (*slot == e) *slot = e->bucket_next;
+    e->bucket_next = NULL;
+}
+
+static void LruRemove(CacheEntry *e) {
+    if (e->lru_prev) e->lru_prev->lru_next = e->lru_next;
+    else lru_head = e->lru_next;
+    if (e->lru_next) e->lru_next->lru_prev = e->lru_prev;
+    else lru_tail = e->lru_prev;
+    e->lru_prev = e->lru_next = NULL;
+}
+
+static void LruPushFront(CacheEntry *e) {
+    e->lru_prev = NULL;
+    e->lru_next = lru_head;
+    if (lru_head) lru_head->lru_prev = e;
+    lru_head = e;
+    if (!lru_tail) lru_tail = e;
+}
+
+static void FreeEntry(CacheEntry *e) {
+    free(e->key);
+    free(e->response);
+    free(e);
+}
+
+// Only finished entries sit in the LRU list; running ones are never evicted.
+static void EvictOverBudget(void) {
+    while (used_bytes > budget && lru_tail) {
+        CacheEntry *victim = lru_tail;
+        LruRemove(victim);
+        Unlink(victim);
+        used_bytes -= EntryBytes(victim);
+        nb_entries--;
+        evictions++;
+        if (victim->waiters == 0) {
+            FreeEntry(victim);
+        } else {
+            victim->state = ENTRY_DROPPED;
+        }
+    }
+}
+
+// Documents may be binary; the copy keeps a trailing NUL for the JSON ones.
+static char* CopyResponse(const CacheEntry *e, size_t *size) {
+    char *copy = malloc(e->response_len + 1);
+    if (!copy) {
+        copy = CreateErrorResponse("Memory allocation failed");
+        *size = copy ? strlen(copy) : 0;
+        return copy;
+    }
+    memcpy(copy, e->response, e->response_len + 1);
+    *size = e->response_len;
+    return copy;
+}
+
+// Waits for the entry's runner; the last waiter on a dropped entry frees it.
+// NULL when the runner kept no document for us.
+static char* WaitForEntry(CacheEntry *e, size_t *size) {
+    e->waiters++;
+    while (e->state == ENTRY_RUNNING)
+        pthread_cond_wait(&cache_done, &cache_lock);
+    e->waiters--;
+
+    char *copy = e->response ? CopyResponse(e, size) : NULL;
+    if (e->state == ENTRY_DROPPED && e->waiters == 0)
+        FreeEntry(e);
+    return copy;
+}
+
+size_t ResponseCacheEntryLimit(void) {
+    pthread_mutex_lock(&cache_lock);
+    size_t limit = budget / 8;
+    pthread_mutex_unlock(&cache_lock);
+    return limit;
+}
+
+CacheOutcome ResponseCacheLookup(const ScheduleRequest *req, char **response, size_t *size, CacheTicket **ticket) {
+    *response = NULL;
+    *ticket = NULL;
+    // Timings differ from run to run, so documents with stats are never shared.
+    if (req->stats) return CACHE_MISS;
+    
+    size_t key_len = 0;
+    char *key = CanonicalKey(req, &key_len);
+    if (!key) return CACHE_MISS;
+    uint64_t hash = HashKey(key, key_len);
+
+    pthread_mutex_lock(&cache_lock);
+    // With no storage nothing could be handed on, so there is nothing to wait for.
+    if (budget == 0) {
+        misses++;
+        pthread_mutex_unlock(&cache_lock);
+        free(key);
+        return CACHE_MISS;
+    }
+    CacheEntry *e = *FindSlot(hash, key, key_len);
+    if (e && e->state == ENTRY_READY) {
+        hits++;
+        LruRemove(e);
+        LruPushFront(e);
+        *response = CopyResponse(e, size);
+        pthread_mutex_unlock(&cache_lock);
+        free(key);
+        return CACHE_HIT;
+    }
+    if (e) {
+        // A runner that ends without a document releases all its waiters at
+        // once; they run side by side, none of them holding a ticket.
+        *response = WaitForEntry(e, size);
+        if (*response) coalesced++;
+        else misses++;
+        pthread_mutex_unlock(&cache_lock);
+        free(key);
+        return *response ? CACHE_COALESCED : CACHE_MISS;
+    }
+
+    e = calloc(1, sizeof(CacheEntry));
+    if (!e) {
+        pthread_mutex_unlock(&cache_lock);
+        free(key);
+        return CACHE_MISS;
+    }
+    misses++;
+    e->hash = hash;
+    e->key = key;
+    e->key_len = key_len;
+    e->state = ENTRY_RUNNING;
+    *FindSlot(hash, key, key_len) = e;
+    pthread_mutex_unlock(&cache_lock);
+
+    *ticket = e;
+    return CACHE_MISS;
+}
+
+void ResponseCacheFinish(CacheTicket *e, char *response, size_t size, int keep) {
+    pthread_mutex_lock(&cache_lock);
+    e->response = response;
+    e->response_len = response ? size : 0;
+
+    if (!response || !keep || EntryBytes(e) > budget) {
+        // Waiters still get this answer, later requests run again.
+        Unlink(e);
+        e->state = ENTRY_DROPPED;
+        if (e->waiters == 0)
+            FreeEntry(e);
+    } else {
+        e->state = ENTRY_READY;
+        LruPushFront(e);
+        used_bytes += EntryBytes(e);
+        nb_entries++;
+        EvictOverBudget();
+    }
+    pthread_cond_broadcast(&cache_done);
+    pthread_mutex_unlock(&cache_lock);
+}
+
+char* GetCacheStatsJson(void) {
+    char *stats = malloc(256);
+    if (!stats) return NULL;
+
+    pthread_mutex_lock(&cache_lock);
+    snprintf(stats, 256,
+             "{\"hits\":%lu,\"misses\":%lu,\"coalesced\":%lu,\"evictions\":%lu,"
+             "\"entries\":%zu,\"bytes\":%zu,\"budget\":%zu}",
+             hits, misses, coalesced, evictions, nb_entries, used_bytes, budget);
+    pthread_mutex_unlock(&cache_lock);
+    return stats;
+}
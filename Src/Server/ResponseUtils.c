@@ -5,12 +5,14 @@
 #include <dirent.h>
 #include <json-c/json.h>
 #include "../../Include/ResponseUtils.h"
+#include "../../Include/Engine.h"
 
 void AddCorsHeaders(struct MHD_Response *response) {
     MHD_add_response_header(response, "Access-Control-Allow-Origin", "*");
     MHD_add_response_header(response, "Access-Control-Allow-Methods", "GET, POST, OPTIONS");
     MHD_add_response_header(response, "Access-Control-Allow-Headers", "Content-Type");
-    MHD_add_response_header(response, "Content-Type", "application/json");
+    if (!MHD_get_response_header(response, "Content-Type"))
+        MHD_add_response_header(response, "Content-Type", "application/json");
 }
 
 char* CreateErrorResponse(const char *error_message) {
@@ -57,13 +59,11 @@ static int DetectAvailableAlgorithms(const char *schedulers_path, json_object *a
   
             json_object *params = json_object_new_object();
             
-            if (strcasecmp(name, "RoundRobin") == 0 || strcasecmp(name, "rr") == 0) {
-                json_object_object_add(params, "quantum", json_object_new_boolean(1));
-            }
-            
-            if (strcasecmp(name, "Multilevel") == 0 || strcasecmp(name, "mlq") == 0) {
-                json_object_object_add(params, "nb_priority", json_object_new_boolean(1));
-                json_object_object_add(params, "cpu_usage_limit", json_object_new_boolean(1));
+            const policy *pol = find_policy(name);
+            if (pol) {
+                for (const char *const *param = pol->params; *param != NULL; param++) {
+                    json_object_object_add(params, *param, json_object_new_boolean(1));
+                }
             }
             
             json_object_object_add(algo, "params", params);
@@ -1,23 +1,22 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <unistd.h>
-#include <time.h>
-#include <ctype.h>
+#include <limits.h>
 #include <json-c/json.h>
 #include "../../Include/SchedulerExecutor.h"
 #include "../../Include/ResponseUtils.h"
+#include "../../Include/JsonOutput.h"
+#include "../../Include/ColumnOutput.h"
+#include "../../Include/Intern.h"
+#include "../../Include/Metrics.h"
 
-int CreateConfigFileFromJson(
-    const char *json_data,
-    char *config_path,
-    size_t config_path_size,
-    char *algorithm,
-    size_t algorithm_size,
-    int *quantum,
-    int *cpu_limit,
-    int *nb_priority
-) {
+int ParseScheduleRequest(const char *json_data, ScheduleRequest *req) {
+    uint64_t parse_start = STATS_ENABLED ? stats_now() : 0;
+    req->processes = NULL;
+    req->nb_processes = 0;
+    req->comments = NULL;
+    
     json_object *root = json_tokener_parse(json_data);
     if (!root) {
         fprintf(stderr, "Failed to parse JSON\n");
@@ -27,23 +26,79 @@ int CreateConfigFileFromJson(
     json_object *jalgo = NULL;
     if (json_object_object_get_ex(root, "algorithm", &jalgo)) {
         const char *algo_str = json_object_get_string(jalgo);
-        strncpy(algorithm, algo_str, algorithm_size - 1);
-        algorithm[algorithm_size - 1] = '\0';
+        strncpy(req->algorithm, algo_str, sizeof(req->algorithm) - 1);
+        req->algorithm[sizeof(req->algorithm) - 1] = '\0';
     } else {
-        strcpy(algorithm, "Fifo");
+        strcpy(req->algorithm, "Fifo");
     }
     
     json_object *jquantum = NULL;
-    *quantum = json_object_object_get_ex(root, "quantum", &jquantum) ? 
+    req->params.quantum = json_object_object_get_ex(root, "quantum", &jquantum) ? 
                json_object_get_int(jquantum) : 2;
     
     json_object *jcpu_limit = NULL;
-    *cpu_limit = json_object_object_get_ex(root, "cpu_usage_limit", &jcpu_limit) ? 
+    req->params.cpu_usage_limit = json_object_object_get_ex(root, "cpu_usage_limit", &jcpu_limit) ? 
                  json_object_get_int(jcpu_limit) : 3;
     
     json_object *jnb_priority = NULL;
-    *nb_priority = json_object_object_get_ex(root, "nb_priority", &jnb_priority) ? 
+    req->params.nb_priority = json_object_object_get_ex(root, "nb_priority", &jnb_priority) ? 
                    json_object_get_int(jnb_priority) : 20;
+    if (req->params.nb_priority > MAX_PRIORITY) {
+        fprintf(stderr, "Invalid nb_priority value: %d\n", req->params.nb_priority);
+        json_object_put(root);
+        return -1;
+    }
+    
+    json_object *jcpus = NULL;
+    req->params.cpus = json_object_object_get_ex(root, "cpus", &jcpus) ? 
+            json_object_get_int(jcpus) : 1;
+    if (req->params.cpus < 1 || req->params.cpus > MAX_CPUS) {
+        fprintf(stderr, "Invalid cpus value: %d\n", req->params.cpus);
+        json_object_put(root);
+        return -1;
+    }
+    
+    json_object *jformat = NULL;
+    const char *format = json_object_object_get_ex(root, "format", &jformat) ?
+                         json_object_get_string(jformat) : NULL;
+    req->format = format && strcmp(format, "compact") == 0 ? FORMAT_COMPACT : FORMAT_JSON;
+    
+    json_object *jstats = NULL;
+    req->stats = STATS_ENABLED && json_object_object_get_ex(root, "stats", &jstats) &&
+                 json_object_get_boolean(jstats);
+    
+    json_object *jmetrics = NULL;
+    req->metrics = json_object_object_get_ex(root, "metrics", &jmetrics) &&
+                   json_object_get_boolean(jmetrics);
+    
+    json_object *jdetail = NULL;
+    const char *detail = json_object_object_get_ex(root, "detail", &jdetail) ?
+                         json_object_get_string(jdetail) : "full";
+    if (detail && strcmp(detail, "summary") == 0) {
+        req->detail = DETAIL_SUMMARY;
+        req->metrics = 1;
+    } else if (detail && strcmp(detail, "sampled") == 0) {
+        req->detail = DETAIL_SAMPLED;
+    } else if (detail && strcmp(detail, "full") == 0) {
+        req->detail = DETAIL_FULL;
+    } else {
+        fprintf(stderr, "Invalid detail: %s\n", detail ? detail : "(null)");
+        json_object_put(root);
+        return -1;
+    }
+    
+    json_object *jsample = NULL;
+    req->sample_every = json_object_object_get_ex(root, "sample_every", &jsample) ?
+                        json_object_get_int(jsample) : 0;
+    req->sample_size = json_object_object_get_ex(root, "sample_size", &jsample) ?
+                       json_object_get_int(jsample) : 0;
+    req->sample_seed = json_object_object_get_ex(root, "seed", &jsample) ?
+                       (uint64_t)json_object_get_int64(jsample) : 1;
+    if (req->sample_every < 0 || req->sample_size < 0 || req->sample_size > MAX_SAMPLE_SIZE) {
+        fprintf(stderr, "Invalid sample: every %d, size %d\n", req->sample_every, req->sample_size);
+        json_object_put(root);
+        return -1;
+    }
     
     json_object *jprocesses = NULL;
     if (!json_object_object_get_ex(root, "processes", &jprocesses)) {
@@ -59,18 +114,25 @@ int CreateConfigFileFromJson(
         return -1;
     }
     
-    snprintf(config_path, config_path_size, 
-             "/tmp/scheduler_config_%d_%ld.txt", 
-             getpid(), (long)time(NULL));
+    // Processes and their events share one block, like the parser's output.
+    size_t nb_events = 0;
+    for (int i = 0; i < nb_processes; i++) {
+        json_object *jevents = NULL;
+        json_object *jproc = json_object_array_get_idx(jprocesses, i);
+        if (json_object_object_get_ex(jproc, "events", &jevents))
+            nb_events += json_object_array_length(jevents);
+    }
     
-    FILE *f = fopen(config_path, "w");
-    if (!f) {
-        fprintf(stderr, "Failed to create config file: %s\n", config_path);
+    size_t head = nb_processes * sizeof(process);
+    process *processes = malloc(head + nb_events * sizeof(event));
+    comment_table *comments = create_comment_table();
+    if (!processes || !comments) {
+        free(processes);
+        free_comment_table(comments);
         json_object_put(root);
         return -1;
     }
-    
-    fprintf(f, "# Config: %s, Processes: %d\n\n", algorithm, nb_processes);
+    event *pool = (event*)((char*)processes + head);
     
     for (int i = 0; i < nb_processes; i++) {
         json_object *jproc = json_object_array_get_idx(jprocesses, i);
@@ -80,128 +142,314 @@ int CreateConfigFileFromJson(
         if (!json_object_object_get_ex(jproc, "name", &jname) ||
             !json_object_object_get_ex(jproc, "arrival", &jarrival) ||
             !json_object_object_get_ex(jproc, "exec_time", &jexec) ||
-            !json_object_object_get_ex(jproc, "priority", &jpriority) ||
-            !json_object_object_get_ex(jproc, "nbEvents", &jnbevents)) {
+            !json_object_object_get_ex(jproc, "priority", &jpriority)) {
             fprintf(stderr, "Missing required process fields for process %d\n", i);
-            fclose(f);
-            remove(config_path);
+            free(processes);
+            free_comment_table(comments);
             json_object_put(root);
             return -1;
         }
         
-        int nbEvents = json_object_get_int(jnbevents);
+        process *p = &processes[i];
+        p->pid = i + 1;
+        p->ppid = 0;
+        const char *name = json_object_get_string(jname);
+        strncpy(p->name, name ? name : "", sizeof(p->name) - 1);
+        p->name[sizeof(p->name) - 1] = '\0';
+        p->arrival = json_object_get_int(jarrival);
+        p->exec_time = json_object_get_int(jexec);
+        p->rem_time = p->exec_time;
+        p->cpu_usage = 0;
+        p->priority = json_object_get_int(jpriority);
+        p->events = pool;
+        p->nbEvents = 0;
         
-        fprintf(f, "%s %d %d %d %d",
-                json_object_get_string(jname),
-                json_object_get_int(jarrival),
-                json_object_get_int(jexec),
-                json_object_get_int(jpriority),
-                nbEvents);
-       
+        // Only the first nbEvents well-formed events are kept; without
+        // nbEvents, all of them.
+        int declared = json_object_object_get_ex(jproc, "nbEvents", &jnbevents) ?
+                       json_object_get_int(jnbevents) : INT_MAX;
         json_object *jevents = NULL;
         if (json_object_object_get_ex(jproc, "events", &jevents)) {
             int event_count = json_object_array_length(jevents);
-            for (int j = 0; j < event_count && j < nbEvents; j++) {
+            for (int j = 0; j < event_count && p->nbEvents < declared; j++) {
                 json_object *jevent = json_object_array_get_idx(jevents, j);
-                json_object *jtime, *jcomment;
+                json_object *jtime = NULL, *jcomment;
                 
                 if (!json_object_object_get_ex(jevent, "t", &jtime)) {
                     json_object_object_get_ex(jevent, "time", &jtime);
                 }
                 
                 if (json_object_object_get_ex(jevent, "comment", &jcomment) && jtime) {
-                    fprintf(f, " %d %s",
-                            json_object_get_int(jtime),
-                            json_object_get_string(jcomment));
+                    pool->t = json_object_get_int(jtime);
+                    const char *comment = json_object_get_string(jcomment);
+                    pool->comment_id = comment_table_intern(comments, comment, comment ? strlen(comment) : 0);
+                    pool++;
+                    p->nbEvents++;
                 }
             }
         }
-        
-        fprintf(f, "\n");
+        if (p->nbEvents == 0)
+            p->events = NULL;
+        sort_events(p);
     }
     
-    fclose(f);
     json_object_put(root);
-    
+    req->processes = processes;
+    req->nb_processes = nb_processes;
+    req->comments = comments;
+    req->parse_ns = STATS_ENABLED ? stats_now() - parse_start : 0;
     return 0;
 }
 
-char* RunSchedulerAndCaptureOutput(
-    const char *config_path,
-    const char *algorithm,
-    int quantum,
-    int cpu_limit,
-    int nb_priority
-) {
-    char command[1024];
-    snprintf(command, sizeof(command),
-             "./scheduler_cli %s %s %d %d %d 2>&1",
-             config_path,
-             algorithm,
-             quantum,
-             cpu_limit,
-             nb_priority);
-    
-    fprintf(stderr, "Executing: %s\n", command);
-    
-    FILE *pipe = popen(command, "r");
-    if (!pipe) {
-        remove(config_path);
-        return CreateErrorResponse("Failed to execute scheduler");
-    }
-    
-    size_t buffer_size = 64 * 1024;
-    char *result = malloc(buffer_size);
-    if (!result) {
-        pclose(pipe);
-        remove(config_path);
-        return CreateErrorResponse("Memory allocation failed");
-    }
-    
-    size_t total_read = 0;
-    size_t read_size;
-    
-    while ((read_size = fread(result + total_read, 1, 
-            buffer_size - total_read - 1, pipe)) > 0) {
-        total_read += read_size;
-        
-        if (total_read + 1024 > buffer_size) {
-            buffer_size *= 2;
-            char *new_result = realloc(result, buffer_size);
-            if (!new_result) {
-                free(result);
-                pclose(pipe);
-                remove(config_path);
-                return CreateErrorResponse("Memory allocation failed");
-            }
-            result = new_result;
+typedef struct ResultWriter {
+    slice_sink sink;
+    int (*finish)(void *ctx);
+} ResultWriter;
+
+static int FinishJson(void *ctx) {
+    return json_writer_finish(ctx);
+}
+
+static int FinishColumns(void *ctx) {
+    return columns_writer_finish(ctx);
+}
+
+// Called after sim_create, which reorders the processes the compact and
+// columnar tables and the metrics list. Stats, metrics and the detail level
+// only apply to the JSON documents.
+static int CreateWriter(FILE *out, const ScheduleRequest *req, sched_stats *stats, ResultWriter *rw) {
+    if (req->format == FORMAT_COLUMNS) {
+        rw->sink.ctx = columns_writer_create(out, req->algorithm, req->processes, req->nb_processes, req->params.cpus);
+        rw->sink.emit = columns_write_execute;
+        rw->finish = FinishColumns;
+        if (rw->sink.ctx) columns_writer_set_comments(rw->sink.ctx, req->comments);
+    } else {
+        rw->sink.ctx = req->format == FORMAT_COMPACT ?
+            json_writer_create_compact(out, req->algorithm, req->processes, req->nb_processes, req->params.cpus) :
+            json_writer_create(out, req->algorithm, req->nb_processes, req->params.cpus);
+        rw->sink.emit = json_write_execute;
+        rw->finish = FinishJson;
+        if (rw->sink.ctx) json_writer_set_comments(rw->sink.ctx, req->comments);
+        if (rw->sink.ctx && req->stats) json_writer_set_stats(rw->sink.ctx, stats);
+        if (rw->sink.ctx && req->detail == DETAIL_SUMMARY) json_writer_set_summary(rw->sink.ctx);
+        if (rw->sink.ctx &&
+            ((req->metrics && json_writer_enable_metrics(rw->sink.ctx, req->processes, req->nb_processes) != 0) ||
+             (req->detail == DETAIL_SAMPLED &&
+              json_writer_set_sampling(rw->sink.ctx, req->sample_every, req->sample_size, req->sample_seed) != 0))) {
+            json_writer_finish(rw->sink.ctx);
+            rw->sink.ctx = NULL;
         }
     }
+    return rw->sink.ctx ? 0 : -1;
+}
+
+// Counts the slices for the metrics, keeps them in a trace when given one
+// and, given a cancel flag, stops the run once it is set.
+typedef struct GuardedSink {
+    slice_sink *inner;
+    const int *cancel;
+    trace *keep;
+    unsigned long slices;
+} GuardedSink;
+
+static int EmitGuarded(void *ctx, const execute *e) {
+    GuardedSink *gs = ctx;
+    if (gs->cancel && __atomic_load_n(gs->cancel, __ATOMIC_RELAXED))
+        return -1;
+    gs->slices++;
+    if (gs->keep) trace_add(gs->keep, e);
+    return gs->inner->emit(gs->inner->ctx, e);
+}
+
+// Runs the request in this process and renders the scheduler_cli document in
+// memory. *failed is set when the returned document is an error response.
+char* RunScheduler(const ScheduleRequest *req, int *failed) {
+    return RunSchedulerCancellable(req, NULL, NULL, failed);
+}
+
+// The run stops at the next slice once *cancel becomes nonzero.
+char* RunSchedulerCancellable(const ScheduleRequest *req, const int *cancel, trace *slices, int *failed) {
+    *failed = 1;
+    const policy *pol = find_policy(req->algorithm);
+    if (!pol) {
+        return CreateErrorResponse("Unknown algorithm");
+    }
     
-    result[total_read] = '\0';
-    
-    int status = pclose(pipe);
-    
-    fprintf(stderr, "Scheduler exit status: %d\n", status);
-    fprintf(stderr, "Scheduler output length: %zu\n", total_read);
+    // The run keeps whatever stats are attached while it is created.
+    sched_stats stats = { .parse_ns = req->parse_ns };
+    sched_stats *outer = req->stats ? stats_attach(&stats) : NULL;
+    sim *run = sim_create(pol, req->processes, req->nb_processes, &req->params);
+    if (req->stats) stats_attach(outer);
+    if (!run) {
+        return CreateErrorResponse("Invalid scheduler parameters");
+    }
     
-    if (total_read > 0) {
-        fprintf(stderr, "First 200 chars of output: %.200s\n", result);
+    char *result = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&result, &size);
+    if (!out) {
+        sim_free(run);
+        return CreateErrorResponse("Memory allocation failed");
     }
     
-    remove(config_path);
+    int status = -1;
+    ResultWriter writer;
+    if (CreateWriter(out, req, &stats, &writer) == 0) {
+        GuardedSink guarded = { &writer.sink, cancel, slices, 0 };
+        slice_sink guarded_sink = { EmitGuarded, &guarded };
+        uint64_t start = MetricsNow();
+        status = sim_run(run, &guarded_sink);
+        if (writer.finish(writer.sink.ctx) != 0) status = -1;
+        MetricsSchedulerRun(req->algorithm, MetricsNow() - start, guarded.slices);
+    }
+    sim_free(run);
+    if (slices) trace_finish(slices);
     
+    if (fclose(out) != 0) status = -1;
+    if (status != 0 && cancel && __atomic_load_n(cancel, __ATOMIC_RELAXED)) {
+        free(result);
+        return CreateErrorResponse("Job cancelled");
+    }
     if (status != 0) {
-        fprintf(stderr, "Scheduler failed with status %d\n", status);
-        fprintf(stderr, "Output: %s\n", result);
+        fprintf(stderr, "Scheduler %s failed\n", req->algorithm);
         free(result);
         return CreateErrorResponse("Scheduler execution failed");
     }
     
-    if (total_read == 0) {
-        free(result);
-        return CreateErrorResponse("Scheduler produced no output");
+    *failed = 0;
+    return result;
+}
+
+#define STREAM_CHUNK (32 * 1024)
+
+struct ScheduleStream {
+    ScheduleRequest req;
+    sim *run;
+    ResultWriter writer;
+    GuardedSink counter;
+    slice_sink counted;
+    sched_stats stats;
+    uint64_t run_micros;
+    int writing;
+    FILE *out;
+    char *pending;
+    size_t len;
+    size_t off;
+    size_t cap;
+    int status;
+};
+
+// The stream's FILE flushes whole chunks into the pending buffer.
+static ssize_t PendingWrite(void *cookie, const char *data, size_t size) {
+    ScheduleStream *st = cookie;
+    if (st->len + size > st->cap) {
+        size_t cap = st->cap ? st->cap * 2 : STREAM_CHUNK;
+        while (cap < st->len + size) cap *= 2;
+        char *bigger = realloc(st->pending, cap);
+        if (!bigger) return -1;
+        st->pending = bigger;
+        st->cap = cap;
+    }
+    memcpy(st->pending + st->len, data, size);
+    st->len += size;
+    return size;
+}
+
+ScheduleStream* OpenScheduleStream(ScheduleRequest *req, char **error) {
+    *error = NULL;
+    const policy *pol = find_policy(req->algorithm);
+    if (!pol) {
+        *error = CreateErrorResponse("Unknown algorithm");
+        return NULL;
     }
     
-    return result;
-}
\ No newline at end of file
+    ScheduleStream *st = calloc(1, sizeof(ScheduleStream));
+    if (!st) {
+        *error = CreateErrorResponse("Memory allocation failed");
+        return NULL;
+    }
+    st->stats.parse_ns = req->parse_ns;
+    sched_stats *outer = req->stats ? stats_attach(&st->stats) : NULL;
+    st->run = sim_create(pol, req->processes, req->nb_processes, &req->params);
+    if (req->stats) stats_attach(outer);
+    if (!st->run) {
+        free(st);
+        *error = CreateErrorResponse("Invalid scheduler parameters");
+        return NULL;
+    }
+    
+    cookie_io_functions_t io = { NULL, PendingWrite, NULL, NULL };
+    st->out = fopencookie(st, "w", io);
+    if (st->out) {
+        setvbuf(st->out, NULL, _IOFBF, STREAM_CHUNK);
+        st->writing = CreateWriter(st->out, req, &st->stats, &st->writer) == 0;
+    }
+    if (!st->writing) {
+        if (st->out) fclose(st->out);
+        sim_free(st->run);
+        free(st->pending);
+        free(st);
+        *error = CreateErrorResponse("Memory allocation failed");
+        return NULL;
+    }
+    
+    st->req = *req;
+    req->processes = NULL;
+    req->nb_processes = 0;
+    req->comments = NULL;
+    st->status = 1;
+    st->counter.inner = &st->writer.sink;
+    st->counted.emit = EmitGuarded;
+    st->counted.ctx = &st->counter;
+    sim_start(st->run, &st->counted);
+    return st;
+}
+
+// Steps the run until a chunk is ready, so at most about one chunk of output
+// is held however long the trace gets. Only the time spent here counts as
+// run time, not the time the client takes to read.
+ssize_t ReadScheduleStream(ScheduleStream *st, char *buf, size_t max) {
+    uint64_t start = st->off == st->len && st->status > 0 ? MetricsNow() : 0;
+    while (st->off == st->len && st->status > 0) {
+        st->off = st->len = 0;
+        int status = sim_step(st->run);
+        if (status <= 0) {
+            if (st->writer.finish(st->writer.sink.ctx) != 0) status = -1;
+            st->writing = 0;
+            if (fclose(st->out) != 0) status = -1;
+            st->out = NULL;
+            if (status != 0) fprintf(stderr, "Scheduler %s failed\n", st->req.algorithm);
+            st->status = status;
+        }
+    }
+    if (start) {
+        st->run_micros += MetricsNow() - start;
+        if (st->status <= 0) MetricsSchedulerRun(st->req.algorithm, st->run_micros, st->counter.slices);
+    }
+    if (st->off == st->len) {
+        return st->status < 0 ? -1 : 0;
+    }
+    
+    size_t n = st->len - st->off < max ? st->len - st->off : max;
+    memcpy(buf, st->pending + st->off, n);
+    st->off += n;
+    return n;
+}
+
+void CloseScheduleStream(ScheduleStream *st) {
+    if (!st) return;
+    if (st->writing) st->writer.finish(st->writer.sink.ctx);
+    if (st->out) fclose(st->out);
+    sim_free(st->run);
+    FreeScheduleRequest(&st->req);
+    free(st->pending);
+    free(st);
+}
+
+void FreeScheduleRequest(ScheduleRequest *req) {
+    free(req->processes);
+    free_comment_table(req->comments);
+    req->processes = NULL;
+    req->nb_processes = 0;
+    req->comments = NULL;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <time.h>
+#include "../../Include/Stats.h"
+
+#ifdef SCHED_STATS
+__thread sched_stats* stats_current;
+#endif
+
+uint64_t stats_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+sched_stats* stats_attach(sched_stats* st){
+#ifdef SCHED_STATS
+    sched_stats* previous = stats_current;
+    stats_current = st;
+    return previous;
+#else
+    (void)st;
+    return NULL;
+#endif
+}
+
+static double ms(uint64_t ns){
+    return ns / 1e6;
+}
+
+static uint64_t simulate_ns(const sched_stats* st){
+    return st->run_ns > st->emit_ns ? st->run_ns - st->emit_ns : 0;
+}
+
+void stats_write_json(FILE* out, const sched_stats* st){
+    fprintf(out, "{\"context_switches\":%llu,\"queue_pushes\":%llu,\"queue_pops\":%llu,"
+                 "\"demotions\":%llu,\"events_extracted\":%llu,\"slices\":%llu,"
+                 "\"allocations\":%llu,\"arena_blocks\":%llu,",
+            (unsigned long long)st->context_switches, (unsigned long long)st->queue_pushes,
+            (unsigned long long)st->queue_pops, (unsigned long long)st->demotions,
+            (unsigned long long)st->events_extracted, (unsigned long long)st->slices,
+            (unsigned long long)st->allocations, (unsigned long long)st->arena_blocks);
+    fprintf(out, "\"phase_ms\":{\"parse\":%.3f,\"sort\":%.3f,\"simulate\":%.3f,\"serialize\":%.3f}}",
+            ms(st->parse_ns), ms(st->sort_ns), ms(simulate_ns(st)), ms(st->emit_ns + st->finish_ns));
+}
+
+void stats_print(FILE* out, const sched_stats* st){
+    fprintf(out, "context switches  %llu\n", (unsigned long long)st->context_switches);
+    fprintf(out, "queue pushes      %llu\n", (unsigned long long)st->queue_pushes);
+    fprintf(out, "queue pops        %llu\n", (unsigned long long)st->queue_pops);
+    fprintf(out, "demotions         %llu\n", (unsigned long long)st->demotions);
+    fprintf(out, "events extracted  %llu\n", (unsigned long long)st->events_extracted);
+    fprintf(out, "slices            %llu\n", (unsigned long long)st->slices);
+    fprintf(out, "allocations       %llu (%llu arena blocks)\n",
+            (unsigned long long)st->allocations, (unsigned long long)st->arena_blocks);
+    fprintf(out, "parse             %10.3f ms\n", ms(st->parse_ns));
+    fprintf(out, "sort              %10.3f ms\n", ms(st->sort_ns));
+    fprintf(out, "simulate          %10.3f ms\n", ms(simulate_ns(st)));
+    fprintf(out, "serialize         %10.3f ms\n", ms(st->emit_ns + st->finish_ns));
+}
@@ -0,0 +1,204 @@
+#include <stdlib.h>
+#include <limits.h>
+#include "../../Include/Trace.h"
+#include "../../Include/Heap.h"
+
+trace* trace_create(int nb_cpus, size_t max_bytes){
+    trace* t = (trace*)calloc(1, sizeof(trace));
+    if (t == NULL) return NULL;
+    t->lanes = (trace_lane*)calloc(nb_cpus, sizeof(trace_lane));
+    if (t->lanes == NULL){
+        free(t);
+        return NULL;
+    }
+    for (int c = 0; c < nb_cpus; c++)
+        t->lanes[c].sorted = 1;
+    t->nb_cpus = nb_cpus;
+    t->max_bytes = max_bytes;
+    t->start = INT_MAX;
+    t->end = INT_MIN;
+    return t;
+}
+
+// Doubles *items (of size bytes each) until it holds need of them.
+static int reserve(void** items, int* cap, int need, size_t size, int first){
+    if (need <= *cap) return 0;
+    int bigger = *cap ? *cap : first;
+    while (bigger < need) bigger *= 2;
+    void* grown = realloc(*items, (size_t)bigger * size);
+    if (grown == NULL) return -1;
+    *items = grown;
+    *cap = bigger;
+    return 0;
+}
+
+void trace_add(trace* t, const execute* e){
+    if (t->truncated) return;
+    size_t bytes = sizeof(trace_slice) + (size_t)e->event_count * sizeof(int);
+    if (e->cpu < 0 || e->cpu >= t->nb_cpus || (t->max_bytes > 0 && t->used + bytes > t->max_bytes)){
+        t->truncated = 1;
+        return;
+    }
+
+    trace_lane* lane = &t->lanes[e->cpu];
+    if (reserve((void**)&lane->slices, &lane->cap, lane->n + 1, sizeof(trace_slice), 64) != 0 ||
+        reserve((void**)&lane->events, &lane->events_cap, lane->nb_events + e->event_count, sizeof(int), 64) != 0){
+        t->truncated = 1;
+        return;
+    }
+
+    if (lane->n > 0 && e->ts < lane->slices[lane->n - 1].ts)
+        lane->sorted = 0;
+    lane->slices[lane->n++] = (trace_slice){ e->p->pid, e->ts, e->te, e->cpu, e->offset };
+    for (int j = 0; j < e->event_count; j++)
+        lane->events[lane->nb_events++] = event_time(e, &e->events[j]);
+    t->n++;
+    t->used += bytes;
+    if (e->ts < t->start) t->start = e->ts;
+    if (e->te > t->end) t->end = e->te;
+}
+
+int trace_emit(void* ctx, const execute* e){
+    trace_add((trace*)ctx, e);
+    return 0;
+}
+
+static int by_time(const void* a, const void* b){
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int by_ts(const void* a, const void* b){
+    const trace_slice* x = (const trace_slice*)a;
+    const trace_slice* y = (const trace_slice*)b;
+    return (x->ts > y->ts) - (x->ts < y->ts);
+}
+
+void trace_finish(trace* t){
+    for (int c = 0; c < t->nb_cpus; c++){
+        trace_lane* lane = &t->lanes[c];
+        if (!lane->sorted){
+            qsort(lane->slices, lane->n, sizeof(trace_slice), by_ts);
+            qsort(lane->events, lane->nb_events, sizeof(int), by_time);
+            lane->sorted = 1;
+        }
+        if (lane->n > 0 && lane->n < lane->cap){
+            trace_slice* slices = (trace_slice*)realloc(lane->slices, lane->n * sizeof(trace_slice));
+            if (slices != NULL){
+                lane->slices = slices;
+                lane->cap = lane->n;
+            }
+        }
+        if (lane->nb_events > 0 && lane->nb_events < lane->events_cap){
+            int* events = (int*)realloc(lane->events, lane->nb_events * sizeof(int));
+            if (events != NULL){
+                lane->events = events;
+                lane->events_cap = lane->nb_events;
+            }
+        }
+    }
+    if (t->n == 0) t->start = t->end = 0;
+}
+
+// First slice of the lane ending after from.
+static int first_ending_after(const trace_lane* lane, int from){
+    int lo = 0, hi = lane->n;
+    while (lo < hi){
+        int mid = lo + (hi - lo) / 2;
+        if (lane->slices[mid].te > from) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+// First slice of the lane starting at or after ts, or strictly after it.
+static int first_starting_from(const trace_lane* lane, int ts, int strict){
+    int lo = 0, hi = lane->n;
+    while (lo < hi){
+        int mid = lo + (hi - lo) / 2;
+        int s = lane->slices[mid].ts;
+        if (s > ts || (!strict && s == ts)) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+long long trace_count(const trace* t, int from, int to){
+    long long n = 0;
+    for (int c = 0; c < t->nb_cpus && from < to; c++){
+        int lo = first_ending_after(&t->lanes[c], from);
+        int hi = first_starting_from(&t->lanes[c], to, 0);
+        if (hi > lo) n += hi - lo;
+    }
+    return n;
+}
+
+typedef struct lane_cursor{
+    const trace_slice* next;
+    const trace_slice* end;
+} lane_cursor;
+
+static int cursor_cmp(const void* a, const void* b){
+    const trace_slice* x = ((const lane_cursor*)a)->next;
+    const trace_slice* y = ((const lane_cursor*)b)->next;
+    if (x->ts != y->ts) return x->ts < y->ts ? -1 : 1;
+    return (x->cpu > y->cpu) - (x->cpu < y->cpu);
+}
+
+// The lanes' ranges merged through a heap of their next slices; a popped
+// cursor goes back in the room it left, so only the first pushes allocate.
+int trace_query(const trace* t, int from, int to, const trace_cursor* after, trace_slice* out, int limit){
+    if (limit <= 0 || from >= to) return 0;
+
+    lane_cursor* cursors = (lane_cursor*)malloc(t->nb_cpus * sizeof(lane_cursor));
+    heap* h = create_heap(cursor_cmp);
+    if (cursors == NULL || h == NULL){
+        free(cursors);
+        free_heap(h);
+        return -1;
+    }
+
+    int err = 0;
+    for (int c = 0; c < t->nb_cpus && !err; c++){
+        const trace_lane* lane = &t->lanes[c];
+        int lo = first_ending_after(lane, from);
+        int hi = first_starting_from(lane, to, 0);
+        if (after != NULL){
+            int resume = first_starting_from(lane, after->ts, c <= after->cpu);
+            if (resume > lo) lo = resume;
+        }
+        if (lo >= hi) continue;
+        cursors[c].next = lane->slices + lo;
+        cursors[c].end = lane->slices + hi;
+        err = heap_push(h, &cursors[c]);
+    }
+
+    // A cursor goes back in right after its pop, so the heap never grows there.
+    int n = err ? -1 : 0;
+    while (!err && n < limit && heap_size(h) > 0){
+        lane_cursor* cur = (lane_cursor*)heap_top(h);
+        heap_pop(h);
+        out[n++] = *cur->next++;
+        if (cur->next < cur->end) heap_push(h, cur);
+    }
+    free_heap(h);
+    free(cursors);
+    return n;
+}
+
+size_t trace_bytes(const trace* t){
+    size_t bytes = sizeof(trace) + t->nb_cpus * sizeof(trace_lane);
+    for (int c = 0; c < t->nb_cpus; c++)
+        bytes += (size_t)t->lanes[c].cap * sizeof(trace_slice) + (size_t)t->lanes[c].events_cap * sizeof(int);
+    return bytes;
+}
+
+void trace_free(trace* t){
+    if (t == NULL) return;
+    for (int c = 0; c < t->nb_cpus; c++){
+        free(t->lanes[c].slices);
+        free(t->lanes[c].events);
+    }
+    free(t->lanes);
+    free(t);
+}
@@ -1,5 +1,4 @@
 #include <stdlib.h>
-#include <string.h>
 #include "../../Include/Scheduler.h"
 
 int compare_process(const void* a, const void* b) {
@@ -11,51 +10,40 @@ int compare_process(const void* a, const void* b) {
     return (e2->priority - e1->priority);
 }
 
+// Higher priority first; ties go to the process stored first in the array.
+int compare_by_priority(const void* a, const void* b) {
+    const process* e1 = (const process*)a;
+    const process* e2 = (const process*)b;
+    if(e1->priority != e2->priority)
+        return (e2->priority - e1->priority);
+
+    return (e1 > e2) - (e1 < e2);
+}
+
+int compare_by_rem_time(const void* a, const void* b) {
+    const process* e1 = (const process*)a;
+    const process* e2 = (const process*)b;
+
+    return (e1->rem_time - e2->rem_time);
+}
+
 int compare_event(const void* a, const void* b) {
     const event* e1 = (const event*)a;
     const event* e2 = (const event*)b;
 
     return (e1->t - e2->t);
 }
-event* getEvents(process p, int tl, int tr, int* out_count) {
-    event* result = NULL;
-    int count = 0;
-
-    for (int i = 0; i < p.nbEvents; i++) {
-      
-        int event_time = p.events[i].t;
-        
-        if (event_time >= tl && event_time < tr) {
-            result = realloc(result, (count + 1) * sizeof(event));
-            result[count].t = event_time;
-            strcpy(result[count].comment, p.events[i].comment);
-            count++;
-        }
-    }
-
-    *out_count = count;
-    return result;
-}
-execute* make_execute(process* p, int ts, int te, int event_count, event* events) {
-    execute* exc = (execute*)malloc(sizeof(execute));
-    exc->p = p;
-    exc->ts = ts;
-    exc->te = te;
-    exc->event_count = event_count;
-    exc->events = events;
-    return exc;
+// Input is usually sorted already and then left untouched. Otherwise qsort
+// does not keep the order of events sharing a time.
+void sort_events(process* p) {
+    int i = 1;
+    while (i < p->nbEvents && compare_event(&p->events[i - 1], &p->events[i]) <= 0)
+        i++;
+    if (i < p->nbEvents)
+        qsort(p->events, p->nbEvents, sizeof(event), compare_event);
+    p->next_event = 0;
 }
 
-process* make_process(process* p){
-    process* ret = (process*)malloc(sizeof(process));
-    ret->pid = p->pid;
-    ret->ppid = p->ppid;
-    ret->arrival = p->arrival;
-    ret->exec_time = p->exec_time;
-    ret->priority = p->priority;
-    strcpy(ret->name, p->name);
-    ret->events = p->events;
-    ret->rem_time = p->rem_time;
-    ret->nbEvents = p->nbEvents;
-    return ret;
-}
\ No newline at end of file
+int event_time(const execute* e, const event* ev) {
+    return e->ts + (ev->t - e->offset);
+}
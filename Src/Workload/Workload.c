@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../../Include/Workload.h"
+#include "../../Include/Parser.h"
+#include "../../Include/Intern.h"
+
+#define ALIGN8(n) (((n) + 7) & ~(uint64_t)7)
+
+static int put(FILE* out, uint64_t* pos, const void* data, size_t size){
+    if (size > 0 && fwrite(data, 1, size, out) != size)
+        return -1;
+    *pos += size;
+    return 0;
+}
+
+// Zero padding up to the start of the next section.
+static int pad_to(FILE* out, uint64_t* pos, uint64_t target){
+    static const char zeros[8];
+    return put(out, pos, zeros, target - *pos);
+}
+
+int workload_write_binary(FILE* out, const process* processes, int n){
+    uint64_t nb_events = 0;
+    for (int i = 0; i < n; i++)
+        nb_events += processes[i].nbEvents;
+
+    // File-local string ids, in order of first use; entry 0 is "".
+    uint32_t nb_global = interned_count();
+    uint32_t* local = (uint32_t*)malloc((nb_global + 1) * sizeof(uint32_t));
+    uint32_t* used = (uint32_t*)malloc((nb_global + 1) * sizeof(uint32_t));
+    if (local == NULL || used == NULL){
+        free(local);
+        free(used);
+        return -1;
+    }
+    memset(local, 0xff, (nb_global + 1) * sizeof(uint32_t));
+    local[0] = 0;
+    used[0] = 0;
+    uint32_t nb_strings = 1;
+    uint64_t texts_size = 1;
+    for (int i = 0; i < n; i++){
+        for (int j = 0; j < processes[i].nbEvents; j++){
+            uint32_t id = processes[i].events[j].comment_id;
+            if (id >= nb_global || local[id] != UINT32_MAX) continue;
+            local[id] = nb_strings;
+            used[nb_strings++] = id;
+            texts_size += strlen(comment_text(id)) + 1;
+        }
+    }
+
+    workload_header h = {0};
+    memcpy(h.magic, WORKLOAD_MAGIC, 4);
+    h.version = WORKLOAD_VERSION;
+    h.process_size = sizeof(workload_record);
+    h.event_size = sizeof(workload_event);
+    h.nb_processes = n;
+    h.nb_events = nb_events;
+    h.nb_strings = nb_strings;
+    h.processes_off = ALIGN8(sizeof(h));
+    h.events_off = ALIGN8(h.processes_off + (uint64_t)n * sizeof(workload_record));
+    h.strings_off = ALIGN8(h.events_off + nb_events * sizeof(workload_event));
+    h.texts_off = ALIGN8(h.strings_off + (uint64_t)nb_strings * sizeof(uint32_t));
+    h.file_size = h.texts_off + texts_size;
+
+    uint64_t pos = 0;
+    int ret = put(out, &pos, &h, sizeof(h)) | pad_to(out, &pos, h.processes_off);
+
+    for (int i = 0; i < n && ret == 0; i++){
+        const process* p = &processes[i];
+        workload_record rec = {
+            .pid = p->pid, .ppid = p->ppid, .arrival = p->arrival, .exec_time = p->exec_time,
+            .priority = p->priority, .nb_events = p->nbEvents,
+        };
+        strncpy(rec.name, p->name, sizeof(rec.name) - 1);
+        ret = put(out, &pos, &rec, sizeof(rec));
+    }
+
+    // Loaded processes keep their events sorted, so they go out in order.
+    ret |= pad_to(out, &pos, h.events_off);
+    for (int i = 0; i < n && ret == 0; i++){
+        for (int j = 0; j < processes[i].nbEvents && ret == 0; j++){
+            const event* e = &processes[i].events[j];
+            workload_event ev = { e->t, e->comment_id < nb_global ? local[e->comment_id] : 0 };
+            ret = put(out, &pos, &ev, sizeof(ev));
+        }
+    }
+
+    ret |= pad_to(out, &pos, h.strings_off);
+    uint32_t off = 0;
+    for (uint32_t i = 0; i < nb_strings && ret == 0; i++){
+        ret = put(out, &pos, &off, sizeof(off));
+        off += strlen(comment_text(used[i])) + 1;
+    }
+
+    ret |= pad_to(out, &pos, h.texts_off);
+    for (uint32_t i = 0; i < nb_strings && ret == 0; i++){
+        const char* text = comment_text(used[i]);
+        ret = put(out, &pos, text, strlen(text) + 1);
+    }
+
+    free(local);
+    free(used);
+    return ret;
+}
+
+int workload_write_text(FILE* out, const process* processes, int n){
+    fprintf(out, "# name arrival exec_time priority nbEvents [event_time event_comment ...]\n");
+    for (int i = 0; i < n; i++){
+        const process* p = &processes[i];
+        fprintf(out, "%s %d %d %d %d", p->name, p->arrival, p->exec_time, p->priority, p->nbEvents);
+        for (int j = 0; j < p->nbEvents; j++)
+            fprintf(out, " %d %s", p->events[j].t, comment_text(p->events[j].comment_id));
+        fprintf(out, "\n");
+    }
+    return ferror(out) ? -1 : 0;
+}
+
+static int section_ok(uint64_t off, uint64_t count, uint64_t size, uint64_t end){
+    return off % 8 == 0 && off <= end && count <= (end - off) / size;
+}
+
+// Checks every offset before it is followed and copies the processes and
+// their events into one block, comment ids mapped onto the intern table.
+static int load_binary(workload* w, const char* base, size_t size){
+    const workload_header* h = (const workload_header*)base;
+    if (size < sizeof(*h) || h->version != WORKLOAD_VERSION || h->file_size != size ||
+        h->process_size != sizeof(workload_record) || h->event_size != sizeof(workload_event) ||
+        h->nb_processes > INT_MAX || h->nb_strings == 0 || h->nb_strings > UINT32_MAX ||
+        !section_ok(h->processes_off, h->nb_processes, sizeof(workload_record), h->events_off) ||
+        !section_ok(h->events_off, h->nb_events, sizeof(workload_event), h->strings_off) ||
+        !section_ok(h->strings_off, h->nb_strings, sizeof(uint32_t), h->texts_off) ||
+        h->texts_off > size)
+        return -1;
+
+    const uint32_t* strings = (const uint32_t*)(base + h->strings_off);
+    const char* texts = base + h->texts_off;
+    size_t texts_size = size - h->texts_off;
+    uint32_t* ids = (uint32_t*)malloc(h->nb_strings * sizeof(uint32_t));
+    if (ids == NULL) return -1;
+    for (uint64_t i = 0; i < h->nb_strings; i++){
+        if (strings[i] >= texts_size || memchr(texts + strings[i], '\0', texts_size - strings[i]) == NULL){
+            free(ids);
+            return -1;
+        }
+        ids[i] = intern_comment(texts + strings[i]);
+    }
+
+    // Processes and events share one block, so free(w->processes) releases both.
+    size_t head = h->nb_processes * sizeof(process);
+    process* out = (process*)malloc(head + h->nb_events * sizeof(event));
+    if (out == NULL){
+        free(ids);
+        return -1;
+    }
+    event* pool = (event*)((char*)out + head);
+
+    const workload_record* records = (const workload_record*)(base + h->processes_off);
+    const workload_event* events = (const workload_event*)(base + h->events_off);
+    uint64_t next = 0;
+    for (uint64_t i = 0; i < h->nb_processes; i++){
+        const workload_record* rec = &records[i];
+        if (rec->nb_events < 0 || (uint64_t)rec->nb_events > h->nb_events - next){
+            free(out);
+            free(ids);
+            return -1;
+        }
+        process* p = &out[i];
+        memset(p, 0, sizeof(*p));
+        p->pid = rec->pid;
+        p->ppid = rec->ppid;
+        memcpy(p->name, rec->name, sizeof(p->name));
+        p->name[sizeof(p->name) - 1] = '\0';
+        p->arrival = rec->arrival;
+        p->exec_time = p->rem_time = rec->exec_time;
+        p->priority = rec->priority;
+        p->nbEvents = rec->nb_events;
+        p->events = p->nbEvents > 0 ? pool + next : NULL;
+        for (int j = 0; j < p->nbEvents; j++, next++){
+            if (events[next].comment >= h->nb_strings){
+                free(out);
+                free(ids);
+                return -1;
+            }
+            p->events[j].t = events[next].t;
+            p->events[j].comment_id = ids[events[next].comment];
+        }
+        sort_events(p);
+    }
+    free(ids);
+
+    w->processes = out;
+    w->n = (int)h->nb_processes;
+    return 0;
+}
+
+// Binary files are mapped read-only and copied out; text files are parsed.
+workload* workload_open(const char* path){
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    workload* w = (workload*)calloc(1, sizeof(workload));
+    struct stat st;
+    char magic[4];
+    if (w == NULL || fstat(fd, &st) != 0){
+        free(w);
+        close(fd);
+        return NULL;
+    }
+
+    if (S_ISREG(st.st_mode) && (size_t)st.st_size >= sizeof(workload_header) &&
+        pread(fd, magic, 4, 0) == 4 && memcmp(magic, WORKLOAD_MAGIC, 4) == 0){
+        void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED){
+            free(w);
+            return NULL;
+        }
+        madvise(map, st.st_size, MADV_SEQUENTIAL);
+        int ret = load_binary(w, (const char*)map, st.st_size);
+        munmap(map, st.st_size);
+        if (ret != 0){
+            free(w);
+            return NULL;
+        }
+        return w;
+    }
+
+    FILE* f = fdopen(fd, "r");
+    if (f == NULL){
+        close(fd);
+        free(w);
+        return NULL;
+    }
+    int ret = parser(f, &w->processes, &w->n);
+    fclose(f);
+    if (ret != 0){
+        free(w);
+        return NULL;
+    }
+    return w;
+}
+
+void workload_close(workload* w){
+    if (w == NULL) return;
+    free(w->processes);
+    free(w);
+}
@@ -0,0 +1,44 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "../../Include/Arena.h"
+#include "../../Include/Queue.h"
+
+int main(){
+    arena* a = create_arena(64);
+    assert(a != NULL);
+
+    // Allocations are aligned and never overlap, even past the first block.
+    char* prev = NULL;
+    for (int i = 0; i < 100; i++){
+        char* p = arena_alloc(a, 24);
+        assert(p != NULL);
+        assert(((uintptr_t)p & 15) == 0);
+        if (prev != NULL)
+            assert(p >= prev + 24 || p + 24 <= prev);
+        prev = p;
+    }
+
+    int* zeros = arena_calloc(a, 1000, sizeof(int));
+    for (int i = 0; i < 1000; i++)
+        assert(zeros[i] == 0);
+
+    // Queue nodes come from the arena and popped ones are reused.
+    queue q = create_queue_in(a);
+    int values[3] = {1, 2, 3};
+    for (int i = 0; i < 3; i++)
+        push(q, &values[i]);
+    assert(size(q) == 3);
+    assert(*(int*)front(q) == 1);
+    pop(q);
+    push(q, &values[0]);
+    assert(size(q) == 3);
+    assert(*(int*)front(q) == 2);
+    assert(*(int*)get_tail(q) == 1);
+
+    arena_reset(a);
+    assert(arena_alloc(a, 8) != NULL);
+
+    free_arena(a);
+    return 0;
+}
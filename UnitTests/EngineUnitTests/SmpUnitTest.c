@@ -0,0 +1,61 @@
+#include <assert.h>
+#include <stdlib.h>
+#include "../../Include/Helpers.h"
+#include "../../Include/Scheduler.h"
+
+int main(){
+    const char* algorithms[] = {"Fifo", "RoundRobin", "PreemptivePriority", "Multilevel"};
+
+    for (int a = 0; a < 4; a++){
+        process* input = getProcessesForTest();
+        sim_params params = { .quantum = 2, .nb_priority = 10, .cpu_usage_limit = 3, .cpus = 2 };
+
+        int out_count = 0;
+        execute* output = simulate(find_policy(algorithms[a]), input, 4, &params, &out_count);
+        assert(output != NULL);
+
+        int work[5] = {0};
+        int used[2] = {0};
+        for (int i = 0; i < out_count; i++){
+            assert(output[i].cpu >= 0 && output[i].cpu < 2);
+            assert(output[i].ts >= output[i].p->arrival);
+            used[output[i].cpu] = 1;
+            work[output[i].p->pid] += output[i].te - output[i].ts;
+
+            // A CPU runs one slice at a time and a process runs on one CPU at a time.
+            for (int j = 0; j < i; j++){
+                int overlap = output[i].ts < output[j].te && output[j].ts < output[i].te;
+                assert(!overlap || (output[i].cpu != output[j].cpu && output[i].p != output[j].p));
+            }
+        }
+
+        for (int i = 0; i < 4; i++)
+            assert(work[input[i].pid] == input[i].exec_time);
+        assert(used[0] && used[1]);
+    }
+
+    // A process the policy leaves out (no work, or a priority Multilevel has
+    // no level for) must not count as load: the two that follow it still get
+    // a CPU each, in arrival order.
+    const char* dropping[] = {"PreemptivePriority", "Multilevel"};
+    for (int a = 0; a < 2; a++){
+        process input[3] = {
+            *getProcessForTest(1, 0, "D", 0, a == 0 ? 0 : 5, a == 0 ? 2 : 99, 0, NULL),
+            *getProcessForTest(2, 0, "A", 0, 5, 2, 0, NULL),
+            *getProcessForTest(3, 0, "B", 0, 5, 2, 0, NULL),
+        };
+        sim_params params = { .nb_priority = 10, .cpu_usage_limit = 3, .cpus = 2 };
+
+        int out_count = 0;
+        execute* output = simulate(find_policy(dropping[a]), input, 3, &params, &out_count);
+        assert(output != NULL);
+        assert(out_count == 2);
+        for (int i = 0; i < out_count; i++){
+            assert(output[i].p->pid != 1);
+            assert(output[i].ts == 0 && output[i].te == 5);
+            assert(output[i].cpu == output[i].p->pid - 2);
+        }
+    }
+
+    return 0;
+}
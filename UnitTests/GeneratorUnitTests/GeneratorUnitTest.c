@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../Include/Generator.h"
+#include "../../Include/Workload.h"
+#include "../../Include/Parser.h"
+
+static void check_valid(const gen_params* params, process* w){
+    int last = 0;
+    for (int i = 0; i < params->nb_processes; i++){
+        process* p = &w[i];
+        assert(p->pid == i + 1 && p->arrival >= last);
+        assert(p->exec_time >= 1 && p->exec_time <= params->max_exec);
+        assert(p->priority >= params->min_priority && p->priority <= params->max_priority);
+        assert(p->nbEvents >= 0 && p->nbEvents <= p->exec_time);
+        for (int j = 0; j < p->nbEvents; j++){
+            assert(p->events[j].t >= 0 && p->events[j].t < p->exec_time);
+            assert(j == 0 || p->events[j - 1].t <= p->events[j].t);
+        }
+        last = p->arrival;
+    }
+}
+
+static int same(const gen_params* params, process* a, process* b){
+    for (int i = 0; i < params->nb_processes; i++){
+        if (a[i].arrival != b[i].arrival || a[i].exec_time != b[i].exec_time ||
+            a[i].priority != b[i].priority || a[i].nbEvents != b[i].nbEvents)
+            return 0;
+        for (int j = 0; j < a[i].nbEvents; j++){
+            if (a[i].events[j].t != b[i].events[j].t || a[i].events[j].comment_id != b[i].events[j].comment_id)
+                return 0;
+        }
+    }
+    return 1;
+}
+
+int main(){
+    gen_params params;
+    gen_defaults(&params);
+    params.nb_processes = 5000;
+    params.seed = 42;
+    params.events_mean = 3;
+
+    const gen_arrivals arrivals[] = { ARRIVALS_POISSON, ARRIVALS_BURSTY };
+    const gen_exec execs[] = { EXEC_EXPONENTIAL, EXEC_PARETO, EXEC_BIMODAL };
+    for (int a = 0; a < 2; a++){
+        for (int e = 0; e < 3; e++){
+            params.arrivals = arrivals[a];
+            params.exec = execs[e];
+
+            // Same seed, same workload; another seed, another one.
+            process* w = gen_workload(&params);
+            process* again = gen_workload(&params);
+            assert(w != NULL && again != NULL);
+            check_valid(&params, w);
+            assert(same(&params, w, again));
+            params.seed++;
+            process* other = gen_workload(&params);
+            params.seed--;
+            assert(!same(&params, w, other));
+            free(w);
+            free(again);
+            free(other);
+        }
+    }
+
+    // Pareto never goes below its minimum.
+    params.exec = EXEC_PARETO;
+    params.exec_mean = 5;
+    process* w = gen_workload(&params);
+    for (int i = 0; i < params.nb_processes; i++)
+        assert(w[i].exec_time >= 5);
+
+    // The text output is parser input and reads back identically.
+    char* text = NULL;
+    size_t size = 0;
+    FILE* out = open_memstream(&text, &size);
+    assert(workload_write_text(out, w, params.nb_processes) == 0);
+    fclose(out);
+    process* parsed;
+    int n;
+    assert(parse_workload(text, size, &parsed, &n) == 0);
+    assert(n == params.nb_processes && same(&params, w, parsed));
+    free(parsed);
+    free(text);
+    free(w);
+
+    // Out-of-range parameters are rejected with a reason.
+    const char* error = NULL;
+    params.rate = 0;
+    assert(gen_check(&params, &error) != 0 && error != NULL);
+    assert(gen_workload(&params) == NULL);
+    params.rate = 1;
+    params.min_priority = 3;
+    params.max_priority = 2;
+    assert(gen_check(&params, &error) != 0);
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "../../Include/Helpers.h"
+#include "../../Include/Heap.h"
+
+int main(){
+    heap* h = create_heap(compare_by_priority);
+    assert(heap_size(h) == 0);
+    assert(heap_top(h) == NULL);
+
+    process* input = getProcessesForTest();
+    for (int i = 0; i < 4; i++)
+        assert(heap_push(h, &input[i]) == 0);
+    assert(heap_size(h) == 4);
+    assert(heap_push(NULL, &input[0]) == -1);
+
+    // P2, P3 and P4 share priority 3: the earliest in the array wins.
+    assert(((process*)heap_top(h))->pid == 2);
+    heap_pop(h);
+    assert(((process*)heap_top(h))->pid == 3);
+    heap_pop(h);
+    assert(((process*)heap_top(h))->pid == 4);
+    heap_pop(h);
+    assert(((process*)heap_top(h))->pid == 1);
+    heap_pop(h);
+    assert(heap_size(h) == 0);
+
+    free_heap(h);
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "../../Include/Intern.h"
+
+int main(){
+    uint32_t a = intern_comment("output after 0 units");
+    uint32_t b = intern_comment("output after 2 units");
+    assert(a != b);
+    assert(intern_comment("output after 0 units") == a);
+    assert(strcmp(comment_text(a), "output after 0 units") == 0);
+    assert(strcmp(comment_text(b), "output after 2 units") == 0);
+
+    // Enough distinct strings to grow the index and span several chunks.
+    char buf[32];
+    uint32_t first = 0;
+    for (int i = 0; i < 10000; i++){
+        sprintf(buf, "e%d", i);
+        uint32_t id = intern_comment(buf);
+        if (i == 0) first = id;
+        assert(strcmp(comment_text(id), buf) == 0);
+    }
+    assert(intern_comment("e0") == first);
+    assert(strcmp(comment_text(a), "output after 0 units") == 0);
+
+    // The empty string and unknown ids both resolve to "".
+    assert(strcmp(comment_text(intern_comment("")), "") == 0);
+    assert(strcmp(comment_text(0xFFFFFFF0u), "") == 0);
+
+    // A private table numbers its own strings and leaves the global one alone.
+    uint32_t global_count = interned_count();
+    comment_table* t = create_comment_table();
+    assert(t != NULL);
+    uint32_t c = comment_table_intern(t, "request only", 12);
+    assert(c == 1 && comment_table_intern(t, "request only!", 12) == c);
+    for (int i = 0; i < 10000; i++){
+        sprintf(buf, "r%d", i);
+        uint32_t id = comment_table_intern(t, buf, strlen(buf));
+        assert(strcmp(comment_table_text(t, id), buf) == 0);
+    }
+    assert(comment_table_count(t) == 10002);
+    assert(strcmp(comment_table_text(t, c), "request only") == 0);
+    assert(strcmp(comment_table_text(t, 0xFFFFFFF0u), "") == 0);
+    assert(interned_count() == global_count);
+    assert(comment_table_count(NULL) == global_count);
+    assert(strcmp(comment_table_text(NULL, a), "output after 0 units") == 0);
+    free_comment_table(t);
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../Include/Scheduler.h"
+#include "../../Include/Generator.h"
+#include "../../Include/Lod.h"
+
+// The process running the longest in [from, to) on cpu, the smallest pid on a tie.
+static int dominant(const execute* output, int out_count, int cpu, long long from, long long to,
+                    int nb_processes, long long* busy){
+    long long* per_pid = calloc(nb_processes + 1, sizeof(long long));
+    for (int i = 0; i < out_count; i++){
+        const execute* e = &output[i];
+        long long lo = e->ts > from ? e->ts : from, hi = e->te < to ? e->te : to;
+        if (e->cpu == cpu && hi > lo) per_pid[e->p->pid] += hi - lo;
+    }
+    int pid = 0;
+    *busy = 0;
+    for (int p = 1; p <= nb_processes; p++){
+        if (per_pid[p] > *busy){
+            pid = p;
+            *busy = per_pid[p];
+        }
+    }
+    free(per_pid);
+    return pid;
+}
+
+// How long pid ran in [from, to) on cpu.
+static long long pid_time(const execute* output, int out_count, int cpu, long long from, long long to, int pid){
+    long long busy = 0;
+    for (int i = 0; i < out_count; i++){
+        const execute* e = &output[i];
+        long long lo = e->ts > from ? e->ts : from, hi = e->te < to ? e->te : to;
+        if (e->cpu == cpu && e->p->pid == pid && hi > lo) busy += hi - lo;
+    }
+    return busy;
+}
+
+int main(){
+    gen_params gen;
+    gen_defaults(&gen);
+    gen.nb_processes = 1000;
+    gen.rate = 0.3;
+    gen.events_mean = 2;
+    process* input = gen_workload(&gen);
+    assert(input != NULL);
+
+    sim_params params = { .quantum = 4, .nb_priority = 10, .cpu_usage_limit = 3, .cpus = 3 };
+    int out_count = 0;
+    execute* output = simulate(find_policy("RoundRobin"), input, gen.nb_processes, &params, &out_count);
+    assert(output != NULL && out_count > 0);
+
+    trace* t = trace_create(3, 0);
+    for (int i = 0; i < out_count; i++)
+        trace_add(t, &output[i]);
+    trace_finish(t);
+    lod_pyramid* p = lod_build(t);
+    assert(p != NULL && p->nb_levels > 1);
+    assert(p->level_size[0] <= out_count / 3 / 4 + 1 && p->level_size[p->nb_levels - 1] == 1);
+
+    // Every level adds up to the lane it comes from.
+    for (int c = 0; c < 3; c++){
+        long long busy = 0;
+        for (int i = 0; i < t->lanes[c].n; i++)
+            busy += t->lanes[c].slices[i].te - t->lanes[c].slices[i].ts;
+        for (int l = 0; l < p->nb_levels; l++){
+            const lod_bucket* b = lod_buckets(p, c, l);
+            long long level_busy = 0;
+            int slices = 0, events = 0;
+            for (int i = 0; i < p->level_size[l]; i++){
+                assert(b[i].busy <= lod_width(p, l) && b[i].top[0].busy <= b[i].busy);
+                for (int k = 1; k < LOD_TOP; k++)
+                    assert(b[i].top[k].busy <= b[i].top[k - 1].busy && (b[i].top[k].pid == 0 || b[i].top[k - 1].pid != 0));
+                level_busy += b[i].busy;
+                slices += b[i].slices;
+                events += b[i].events;
+            }
+            assert(level_busy == busy && slices == t->lanes[c].n && events == t->lanes[c].nb_events);
+        }
+
+        // Level 0 names the process that ran the longest; above it the named
+        // process's time is never more than it ran, nor more than the longest.
+        for (int l = 0; l < p->nb_levels; l++){
+            long long width = lod_width(p, l);
+            const lod_bucket* b = lod_buckets(p, c, l);
+            for (int i = 0; i < p->level_size[l]; i += p->level_size[l] / 50 + 1){
+                long long from = p->origin + i * width, expected;
+                int pid = dominant(output, out_count, c, from, from + width, gen.nb_processes, &expected);
+                if (l == 0){
+                    assert(b[i].top[0].pid == pid && b[i].top[0].busy == expected);
+                }else if (b[i].top[0].pid != 0){
+                    long long ran = pid_time(output, out_count, c, from, from + width, b[i].top[0].pid);
+                    assert(b[i].top[0].busy <= ran && ran <= expected);
+                }
+            }
+        }
+    }
+
+    // At most one bucket per pixel, on the finest level that allows it.
+    int span = t->end - t->start;
+    const int pixels[] = { 1, 7, 100, 2000 };
+    for (int k = 0; k < 4; k++){
+        for (int from = t->start - 10; from < t->end; from += span / 5 + 1){
+            for (int to = from + 1; to <= t->end + 10; to += span / 3 + 1){
+                int first, last;
+                int level = lod_level(p, from, to, pixels[k], &first, &last);
+                assert(last - first + 1 <= pixels[k]);
+                if (to <= t->start){
+                    assert(last < first);
+                    continue;
+                }
+                assert(first <= last);
+                assert(p->origin + first * lod_width(p, level) < to);
+                assert(p->origin + (last + 1) * lod_width(p, level) > from);
+                if (level > 0){
+                    long long w = lod_width(p, level - 1);
+                    long long lo = from > p->origin ? from - p->origin : 0;
+                    long long hi = (long long)to - p->origin - 1;
+                    long long n = (hi / w < p->level_size[level - 1] ? hi / w : p->level_size[level - 1] - 1) - lo / w + 1;
+                    assert(n > pixels[k]);
+                }
+            }
+        }
+    }
+
+    // A window past the run touches no bucket.
+    int first, last;
+    lod_level(p, t->end + 100, t->end + 200, 10, &first, &last);
+    assert(last < first);
+
+    // A bucket lists the processes it kept, longest first, and no unused entry.
+    lod_bucket b = { .busy = 9, .slices = 3, .events = 1, .top = {{4, 5}, {2, 3}} };
+    char* json = NULL;
+    size_t size = 0;
+    FILE* out = open_memstream(&json, &size);
+    assert(out != NULL);
+    lod_write_json(out, &b, 32);
+    fclose(out);
+    assert(strcmp(json, "{\"t\":32,\"busy\":9,\"top\":[{\"pid\":4,\"busy\":5},{\"pid\":2,\"busy\":3}],"
+                        "\"slices\":3,\"events\":1}") == 0);
+    free(json);
+
+    lod_free(p);
+    trace_free(t);
+    free(output);
+    free(input);
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <string.h>
 #include "../../Include/Helpers.h"
 #include "../../Include/Scheduler.h"
+#include "../../Include/Intern.h"
 
 int main() {
     freopen("TestsOutput/MultilevelUnitTest.txt", "w", stdout);
@@ -16,7 +17,7 @@ int main() {
         printf("%s %d %d\n", output[i].p->name, output[i].ts, output[i].te);
         printf("number of events is %d :\n", output[i].event_count);
         for (int j = 0; j < output[i].event_count; j++)
-            printf("%d %s\n",output[i].events[j].t, output[i].events[j].comment);
+            printf("%d %s\n",event_time(&output[i], &output[i].events[j]), comment_text(output[i].events[j].comment_id));
         printf("\n");
     }
 
@@ -0,0 +1,74 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../Include/Helpers.h"
+#include "../../Include/Scheduler.h"
+#include "../../Include/ColumnOutput.h"
+#include "../../Include/Intern.h"
+
+int main(){
+    process* input = getProcessesForTest();
+    sim_params params = { .quantum = 2, .nb_priority = 10, .cpu_usage_limit = 3, .cpus = 2 };
+
+    // Reference slices from the same run.
+    process* copy = getProcessesForTest();
+    int count = 0;
+    execute* expected = simulate(find_policy("RoundRobin"), copy, 4, &params, &count);
+    assert(expected != NULL && count > 0);
+
+    sim* run = sim_create(find_policy("RoundRobin"), input, 4, &params);
+    char* data = NULL;
+    size_t size = 0;
+    FILE* out = open_memstream(&data, &size);
+    columns_writer* w = columns_writer_create(out, "RoundRobin", input, 4, 2);
+    slice_sink sink = { columns_write_execute, w };
+    assert(sim_run(run, &sink) == 0);
+    assert(columns_writer_finish(w) == 0);
+    fclose(out);
+
+    columns_header h;
+    memcpy(&h, data, sizeof(h));
+    assert(memcmp(h.magic, COLUMNS_MAGIC, 4) == 0 && h.version == COLUMNS_VERSION);
+    assert(h.nb_processes == 4 && h.nb_slices == (uint32_t)count && h.nb_cpus == 2);
+    assert(strcmp(h.algorithm, "RoundRobin") == 0);
+
+    const int32_t* col = (const int32_t*)(data + sizeof(h));
+    const int32_t* pid = col;
+    const int32_t* name = pid + 4;
+    const int32_t* slice_pid = name + 4 * 4;
+    const int32_t* ts = slice_pid + count;
+    const int32_t* te = ts + count;
+    const int32_t* cpu = te + count;
+    const int32_t* first_event = cpu + count;
+    const int32_t* times = first_event + count + 1;
+    const int32_t* comments = times + h.nb_events;
+    const int32_t* offsets = comments + h.nb_events;
+    const char* blob = (const char*)(offsets + h.nb_strings + 1);
+    assert(blob + h.strings_size == data + size);
+
+    for (int i = 0; i < 4; i++){
+        const char* s = blob + offsets[name[i]];
+        int len = offsets[name[i] + 1] - offsets[name[i]];
+        assert(len == (int)strlen(input[i].name) && memcmp(s, input[i].name, len) == 0);
+        assert(pid[i] == input[i].pid);
+    }
+
+    for (int i = 0; i < count; i++){
+        assert(slice_pid[i] == expected[i].p->pid);
+        assert(ts[i] == expected[i].ts && te[i] == expected[i].te && cpu[i] == expected[i].cpu);
+        assert(first_event[i + 1] - first_event[i] == expected[i].event_count);
+        for (int j = 0; j < expected[i].event_count; j++){
+            int k = first_event[i] + j;
+            const char* text = comment_text(expected[i].events[j].comment_id);
+            assert(times[k] == event_time(&expected[i], &expected[i].events[j]));
+            assert(offsets[comments[k] + 1] - offsets[comments[k]] == (int)strlen(text));
+            assert(memcmp(blob + offsets[comments[k]], text, strlen(text)) == 0);
+        }
+    }
+
+    sim_free(run);
+    free(expected);
+    free(data);
+    return 0;
+}
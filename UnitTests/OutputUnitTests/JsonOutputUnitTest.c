@@ -0,0 +1,104 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../Include/Helpers.h"
+#include "../../Include/Scheduler.h"
+#include "../../Include/JsonOutput.h"
+#include "../../Include/Intern.h"
+
+static char* render(int compact, json_detail detail, size_t* size){
+    process* input = getProcessesForTest();
+    sim_params params = { .quantum = 2, .nb_priority = 10, .cpu_usage_limit = 3, .cpus = 1 };
+    sim* run = sim_create(find_policy("RoundRobin"), input, 4, &params);
+    assert(run != NULL);
+
+    char* text = NULL;
+    FILE* out = open_memstream(&text, size);
+    json_writer* w = compact ? json_writer_create_compact(out, "RoundRobin", input, 4, 1)
+                             : json_writer_create(out, "RoundRobin", 4, 1);
+    if (detail == DETAIL_SUMMARY){
+        json_writer_set_summary(w);
+        assert(json_writer_enable_metrics(w, input, 4) == 0);
+    }
+    if (detail == DETAIL_SAMPLED) assert(json_writer_set_sampling(w, 2, 0, 1) == 0);
+    slice_sink sink = { json_write_execute, w };
+    assert(sim_run(run, &sink) == 0);
+    assert(json_writer_finish(w) == 0);
+    fclose(out);
+    sim_free(run);
+    return text;
+}
+
+static int count(const char* text, const char* needle){
+    int n = 0;
+    for (const char* p = text; (p = strstr(p, needle)) != NULL; p++)
+        n++;
+    return n;
+}
+
+int main(){
+    size_t full_size, compact_size;
+    char* full = render(0, DETAIL_FULL, &full_size);
+    char* compact = render(1, DETAIL_FULL, &compact_size);
+
+    // Same slices, one line, and the process table appears once.
+    assert(strncmp(compact, "{\"success\":true,\"format\":\"compact\"", 34) == 0);
+    assert(count(compact, "\n") == 1 && compact[compact_size - 1] == '\n');
+    assert(count(compact, "\"ts\":") == count(full, "\"ts\":"));
+    assert(count(compact, "\"exec_time\":") == 4);
+    assert(strstr(compact, "\"timelines\":[{\"cpu\":0,") != NULL);
+    assert(compact_size * 3 < full_size);
+
+    // The n-th slice keeps its bounds.
+    const char* f = full;
+    const char* c = compact;
+    while ((f = strstr(f, "\"ts\": ")) != NULL){
+        c = strstr(c, "\"ts\":");
+        assert(c != NULL);
+        int fts, fte, cts, cte;
+        assert(sscanf(f, "\"ts\": %d,\n \"te\": %d", &fts, &fte) == 2);
+        assert(sscanf(c, "\"ts\":%d,\"te\":%d", &cts, &cte) == 2);
+        assert(fts == cts && fte == cte);
+        f++;
+        c++;
+    }
+
+    // Every other slice, and the count of all of them.
+    size_t size;
+    char* sampled = render(1, DETAIL_SAMPLED, &size);
+    int total = count(compact, "\"ts\":");
+    assert(count(sampled, "\"ts\":") == (total + 1) / 2);
+    char expected[64];
+    snprintf(expected, sizeof(expected), "\"totalSlices\":%d", total);
+    assert(strstr(sampled, "\"detail\":\"sampled\"") != NULL && strstr(sampled, expected) != NULL);
+
+    // A summary keeps no slice but the metrics.
+    char* summary = render(1, DETAIL_SUMMARY, &size);
+    assert(count(summary, "\"ts\":") == 0 && strstr(summary, expected) != NULL);
+    assert(strstr(summary, "\"metrics\":{") != NULL);
+
+    // Names and comments are escaped in both schemas.
+    comment_table* comments = create_comment_table();
+    event ev = { 0, comment_table_intern(comments, "a\tb\n\x01", 5) };
+    process p = { .pid = 1, .name = "say \"hi\"\\", .exec_time = 1, .nbEvents = 1, .events = &ev };
+    execute e = { &p, 0, 1, 1, &ev, 0, 0 };
+    for (int k = 0; k < 2; k++){
+        char* text = NULL;
+        FILE* out = open_memstream(&text, &size);
+        json_writer* w = k ? json_writer_create_compact(out, "Fifo", &p, 1, 1) : json_writer_create(out, "Fifo", 1, 1);
+        json_writer_set_comments(w, comments);
+        assert(json_write_execute(w, &e) == 0 && json_writer_finish(w) == 0);
+        fclose(out);
+        assert(strstr(text, "say \\\"hi\\\"\\\\\"") != NULL);
+        assert(strstr(text, "a\\tb\\n\\u0001\"") != NULL);
+        free(text);
+    }
+    free_comment_table(comments);
+
+    free(full);
+    free(compact);
+    free(sampled);
+    free(summary);
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../Include/Parser.h"
+#include "../../Include/Intern.h"
+
+int main(){
+    const char* text =
+        "# name arrival exec_time priority nbEvents [t comment]...\n"
+        "\n"
+        "P1 0 5 2 2 3 late 1 early\r\n"
+        "   P2\t1 3 4 0\n"
+        "AVeryLongProcessNameIndeed 2 1 0 1 0 x";
+
+    process* tab = NULL;
+    int n = 0;
+    assert(parse_workload(text, strlen(text), &tab, &n) == 0);
+    assert(n == 3);
+
+    assert(tab[0].pid == 1 && strcmp(tab[0].name, "P1") == 0);
+    assert(tab[0].exec_time == 5 && tab[0].rem_time == 5 && tab[0].priority == 2);
+    // Events come back sorted by time.
+    assert(tab[0].nbEvents == 2);
+    assert(tab[0].events[0].t == 1 && strcmp(comment_text(tab[0].events[0].comment_id), "early") == 0);
+    assert(tab[0].events[1].t == 3 && strcmp(comment_text(tab[0].events[1].comment_id), "late") == 0);
+
+    assert(tab[1].pid == 2 && tab[1].arrival == 1 && tab[1].events == NULL);
+    // Names are cut to fit, the last line needs no newline.
+    assert(strlen(tab[2].name) == sizeof(tab[2].name) - 1);
+    assert(tab[2].nbEvents == 1 && tab[2].events[0].t == 0);
+    free(tab);
+
+    // Missing fields, a short event list and non-numeric values are rejected.
+    const char* bad[] = { "P1 0 5 2\n", "P1 0 5 2 2 1 a\n", "P1 0 5x 2 0\n", "P1 0 5 2 -1\n" };
+    for (int i = 0; i < 4; i++)
+        assert(parse_workload(bad[i], strlen(bad[i]), &tab, &n) == -1);
+
+    // Streams that cannot be mapped are read first.
+    FILE* f = fmemopen((void*)text, strlen(text), "r");
+    assert(parser(f, &tab, &n) == 0 && n == 3);
+    fclose(f);
+    free(tab);
+
+    f = fopen("TestFiles/config.txt", "r");
+    assert(f != NULL);
+    assert(parser(f, &tab, &n) == 0 && n > 0);
+    fclose(f);
+    free(tab);
+    return 0;
+}
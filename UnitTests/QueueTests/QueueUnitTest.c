@@ -15,5 +15,8 @@ int main(){
     q = pop(q);
     assert(size(q) == 0);
 
+    // A push that cannot add the element says so.
+    assert(push(NULL, p1) == NULL);
+
     return 0;
 }
\ No newline at end of file
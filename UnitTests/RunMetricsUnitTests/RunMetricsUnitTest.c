@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "../../Include/RunMetrics.h"
+
+static process make(int pid, int arrival, int exec_time){
+    process p;
+    memset(&p, 0, sizeof(p));
+    p.pid = pid;
+    p.arrival = arrival;
+    p.exec_time = exec_time;
+    return p;
+}
+
+static void slice(run_metrics* m, process* p, int ts, int te, int cpu, int offset){
+    execute e = { p, ts, te, 0, NULL, cpu, offset };
+    run_metrics_add(m, &e);
+}
+
+int main(){
+    // P1 arrives at 1 and runs 1-3, is preempted by P2 (3-5), then finishes
+    // 5-8 in two back-to-back slices on the same CPU. CPU 1 is idle apart
+    // from P3 running 4-6.
+    process procs[3] = { make(1, 1, 5), make(2, 2, 2), make(3, 4, 2) };
+    run_metrics* m = run_metrics_create(procs, 3, 2);
+    assert(m != NULL);
+    slice(m, &procs[0], 1, 3, 0, 0);
+    slice(m, &procs[1], 3, 5, 0, 0);
+    slice(m, &procs[2], 4, 6, 1, 0);
+    slice(m, &procs[0], 5, 7, 0, 2);
+    slice(m, &procs[0], 7, 8, 0, 4);
+
+    metrics_summary s;
+    run_metrics_summarize(m, &s);
+    assert(s.completed == 3);
+    assert(s.makespan == 7 && s.busy == 9 && s.idle == 5);
+    assert(fabs(s.utilization - 9.0 / 14) < 1e-9);
+    assert(fabs(s.throughput - 3.0 / 7) < 1e-9);
+
+    // Turnarounds 7, 3, 2; waits 2, 1, 0; responses 0, 1, 0.
+    assert(fabs(s.avg_turnaround - 4.0) < 1e-9 && s.max_turnaround == 7);
+    assert(fabs(s.avg_waiting - 1.0) < 1e-9 && s.max_waiting == 2);
+    assert(fabs(s.avg_response - 1.0 / 3) < 1e-9 && s.max_response == 1);
+    assert(s.preemptions == 1);
+
+    double x[3] = { 5.0 / 7, 2.0 / 3, 1.0 };
+    double sum = x[0] + x[1] + x[2], sq = x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+    assert(fabs(s.fairness - sum * sum / (3 * sq)) < 1e-9);
+
+    char* text = NULL;
+    size_t size = 0;
+    FILE* out = open_memstream(&text, &size);
+    run_metrics_write_json(out, m, 1);
+    fclose(out);
+    assert(strstr(text, "{\"pid\":1,\"waiting\":2,\"turnaround\":7,\"response\":0,\"preemptions\":1}") != NULL);
+    free(text);
+
+    // Without the per-process list the document ends after the summary.
+    out = open_memstream(&text, &size);
+    run_metrics_write_json(out, m, 0);
+    fclose(out);
+    assert(strstr(text, "processes") == NULL && text[strlen(text) - 1] == '}');
+    free(text);
+    run_metrics_free(m);
+
+    // A run stopped early: P2 never ran, P1 did not finish.
+    process early[2] = { make(1, 0, 4), make(2, 1, 3) };
+    m = run_metrics_create(early, 2, 1);
+    slice(m, &early[0], 0, 2, 0, 0);
+    run_metrics_summarize(m, &s);
+    assert(s.completed == 0 && s.busy == 2 && s.throughput == 0);
+    out = open_memstream(&text, &size);
+    run_metrics_write_json(out, m, 1);
+    fclose(out);
+    assert(strstr(text, "\"fairness\":null") != NULL);
+    assert(strstr(text, "{\"pid\":2,\"waiting\":null,\"turnaround\":null,\"response\":null,\"preemptions\":0}") != NULL);
+    free(text);
+    run_metrics_free(m);
+    return 0;
+}
@@ -1,11 +1,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../../Include/Helpers.h"
+#include "../../Include/Intern.h"
 
 event getEventForTest(int t, char* comment){
     event event;
     event.t = t;
-    strcpy(event.comment, comment);
+    event.comment_id = intern_comment(comment);
     return event;
 }
 
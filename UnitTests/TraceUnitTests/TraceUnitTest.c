@@ -0,0 +1,113 @@
+#include <assert.h>
+#include <stdlib.h>
+#include "../../Include/Scheduler.h"
+#include "../../Include/Generator.h"
+#include "../../Include/Trace.h"
+
+static int in_window(const execute* e, int from, int to){
+    return e->ts < to && e->te > from;
+}
+
+static int before(const execute* e, int ts, int cpu){
+    return e->ts < ts || (e->ts == ts && e->cpu <= cpu);
+}
+
+// Every slice of the run in the window and after the cursor, none twice,
+// in (ts, cpu) order.
+static void check_page(execute* output, int out_count, const trace_slice* page, int n,
+                       int from, int to, const trace_cursor* after){
+    int expected = 0;
+    for (int i = 0; i < out_count; i++){
+        if (in_window(&output[i], from, to) && (!after || !before(&output[i], after->ts, after->cpu)))
+            expected++;
+    }
+    assert(n <= expected);
+    for (int j = 0; j < n; j++){
+        assert(page[j].ts < to && page[j].te > from);
+        assert(j == 0 || page[j - 1].ts < page[j].ts ||
+               (page[j - 1].ts == page[j].ts && page[j - 1].cpu < page[j].cpu));
+        int found = 0;
+        for (int i = 0; i < out_count && !found; i++){
+            found = output[i].ts == page[j].ts && output[i].cpu == page[j].cpu &&
+                    output[i].te == page[j].te && output[i].p->pid == page[j].pid &&
+                    output[i].offset == page[j].offset;
+        }
+        assert(found);
+    }
+}
+
+int main(){
+    gen_params gen;
+    gen_defaults(&gen);
+    gen.nb_processes = 2000;
+    gen.rate = 0.5;
+    process* input = gen_workload(&gen);
+    assert(input != NULL);
+
+    sim_params params = { .quantum = 3, .nb_priority = 10, .cpu_usage_limit = 3, .cpus = 4 };
+    int out_count = 0;
+    execute* output = simulate(find_policy("RoundRobin"), input, gen.nb_processes, &params, &out_count);
+    assert(output != NULL && out_count > 0);
+
+    // Added in reverse, so that every lane needs sorting.
+    trace* t = trace_create(4, 0);
+    assert(t != NULL);
+    for (int i = out_count - 1; i >= 0; i--)
+        assert(trace_emit(t, &output[i]) == 0);
+    trace_finish(t);
+    assert(t->n == out_count && !t->truncated);
+    assert(trace_count(t, t->start, t->end) == out_count);
+
+    trace_slice* page = malloc(out_count * sizeof(trace_slice));
+    int span = t->end - t->start;
+    for (int w = 1; w <= 64; w *= 4){
+        for (int from = t->start - 5; from < t->end; from += span / 7 + 1){
+            int to = from + span / w + 1;
+            long long expected = 0;
+            for (int i = 0; i < out_count; i++)
+                expected += in_window(&output[i], from, to);
+            assert(trace_count(t, from, to) == expected);
+
+            int n = trace_query(t, from, to, NULL, page, out_count);
+            assert(n == expected);
+            check_page(output, out_count, page, n, from, to, NULL);
+        }
+    }
+
+    // Paging with the cursor reads the whole window once.
+    int from = t->start + span / 3, to = t->start + 2 * span / 3;
+    long long total = trace_count(t, from, to), seen = 0;
+    trace_cursor cursor;
+    int n = trace_query(t, from, to, NULL, page, 50);
+    while (n > 0){
+        check_page(output, out_count, page, n, from, to, seen > 0 ? &cursor : NULL);
+        seen += n;
+        cursor = (trace_cursor){ page[n - 1].ts, page[n - 1].cpu };
+        n = trace_query(t, from, to, &cursor, page, 50);
+    }
+    assert(n == 0 && seen == total);
+
+    // Empty and inverted windows.
+    assert(trace_count(t, t->end, t->end + 10) == 0);
+    assert(trace_query(t, t->end, t->end + 10, NULL, page, 10) == 0);
+    assert(trace_query(t, 10, 5, NULL, page, 10) == 0);
+    for (int i = 0; i < t->lanes[0].n; i++){
+        const trace_slice* s = &t->lanes[0].slices[i];
+        if (s->te - s->ts < 3) continue;
+        assert(trace_count(t, s->ts + 1, s->ts + 1) == 0 && trace_count(t, s->ts + 2, s->ts + 1) == 0);
+        break;
+    }
+    trace_free(t);
+
+    // A full trace stops growing instead of failing the run.
+    t = trace_create(4, 10 * sizeof(trace_slice));
+    for (int i = 0; i < out_count; i++)
+        assert(trace_emit(t, &output[i]) == 0);
+    assert(t->n > 0 && t->n <= 10 && t->truncated && t->used <= t->max_bytes);
+    trace_free(t);
+
+    free(page);
+    free(output);
+    free(input);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <assert.h>
+#include "../../Include/Workload.h"
+#include "../../Include/Intern.h"
+
+static void write_binary(const char* path, workload* w){
+    FILE* f = fopen(path, "wb");
+    assert(f != NULL);
+    assert(workload_write_binary(f, w->processes, w->n) == 0);
+    fclose(f);
+}
+
+int main(){
+    workload* text = workload_open("TestFiles/config.txt");
+    assert(text != NULL && text->n > 0);
+
+    char path[] = "/tmp/workload_test_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    write_binary(path, text);
+
+    // Same processes and events back.
+    workload* bin = workload_open(path);
+    assert(bin != NULL);
+    assert(bin->n == text->n);
+    for (int i = 0; i < bin->n; i++){
+        process* a = &text->processes[i];
+        process* b = &bin->processes[i];
+        assert(strcmp(a->name, b->name) == 0);
+        assert(a->pid == b->pid && a->arrival == b->arrival && a->exec_time == b->exec_time);
+        assert(b->rem_time == b->exec_time && a->priority == b->priority);
+        assert(a->nbEvents == b->nbEvents);
+        for (int j = 0; j < a->nbEvents; j++){
+            assert(a->events[j].t == b->events[j].t);
+            assert(a->events[j].comment_id == b->events[j].comment_id);
+        }
+    }
+
+    // Writes to the processes stay in this process, the file is unchanged.
+    bin->processes[0].rem_time = -1;
+    workload* again = workload_open(path);
+    assert(again->processes[0].rem_time == again->processes[0].exec_time);
+    workload_close(again);
+    workload_close(bin);
+
+    // A truncated file is rejected.
+    FILE* f = fopen(path, "r+b");
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    assert(truncate(path, size - 1) == 0);
+    assert(workload_open(path) == NULL);
+
+    unlink(path);
+    workload_close(text);
+    return 0;
+}
@@ -1,4 +1,4 @@
-import { Process, Execute, AlgorithmInfo } from './types';
+import { Process, Execute, AlgorithmInfo, CpuTimeline, ScheduleColumns, ScheduleMetrics, RunSlicesPage, RunLod } from './types';
 
 const API_BASE_URL = import.meta.env.VITE_API_SERVER_URL;
 const REQUEST_TIMEOUT = 10000; 
@@ -7,7 +7,12 @@ export interface ScheduleResponse {
   success: boolean;
   algorithm: string;
   totalProcesses: number;
+  cpus?: number;
   executes: Execute[];
+  timelines?: CpuTimeline[];
+  metrics?: ScheduleMetrics;
+  detail?: 'full' | 'summary' | 'sampled';
+  totalSlices?: number;
   error?: string;
 }
 
@@ -17,6 +22,12 @@ export interface ScheduleRequest {
   quantum?: number;
   nb_priority?: number;
   cpu_usage_limit?: number;
+  cpus?: number;
+  metrics?: boolean;
+  detail?: 'full' | 'summary' | 'sampled';
+  sample_every?: number;
+  sample_size?: number;
+  seed?: number;
 }
 
 export async function scheduleProcesses(
@@ -24,7 +35,8 @@ export async function scheduleProcesses(
   algorithmName: string,  
   quantum?: number,
   nbPriority?: number,
-  cpuUsageLimit?: number
+  cpuUsageLimit?: number,
+  cpus?: number
 ): Promise<Execute[]> {
   
   try {
@@ -37,6 +49,7 @@ export async function scheduleProcesses(
       ...(quantum !== undefined && { quantum }),
       ...(nbPriority !== undefined && { nb_priority: nbPriority }),
       ...(cpuUsageLimit !== undefined && { cpu_usage_limit: cpuUsageLimit }),
+      ...(cpus !== undefined && { cpus }),
     };
     
     console.log('Sending request:', requestBody);
@@ -73,6 +86,162 @@ export async function scheduleProcesses(
   }
 }
 
+export const COLUMNS_MIME = 'application/vnd.scheduler.columns';
+const COLUMNS_MAGIC = 'SCHC';
+const COLUMNS_VERSION = 1;
+const COLUMNS_HEADER_SIZE = 64;
+
+/**
+ * Views a columnar result (layout documented in Include/ColumnOutput.h) as
+ * typed arrays over the response buffer; nothing is copied except the strings.
+ */
+export function parseScheduleColumns(buffer: ArrayBuffer): ScheduleColumns {
+  const view = new DataView(buffer);
+  const magic = new TextDecoder().decode(new Uint8Array(buffer, 0, 4));
+  if (buffer.byteLength < COLUMNS_HEADER_SIZE || magic !== COLUMNS_MAGIC) {
+    throw new Error('Not a columnar schedule');
+  }
+  const version = view.getUint32(4, true);
+  if (version !== COLUMNS_VERSION) {
+    throw new Error(`Unsupported columnar schedule version ${version}`);
+  }
+
+  const nbProcesses = view.getUint32(8, true);
+  const nbSlices = view.getUint32(12, true);
+  const nbEvents = view.getUint32(16, true);
+  const nbStrings = view.getUint32(20, true);
+  const stringsSize = view.getUint32(24, true);
+  const cpus = view.getUint32(28, true);
+  const algorithmBytes = new Uint8Array(buffer, 32, 32);
+  const algorithmEnd = algorithmBytes.indexOf(0);
+  const algorithm = new TextDecoder().decode(
+    algorithmEnd < 0 ? algorithmBytes : algorithmBytes.subarray(0, algorithmEnd)
+  );
+
+  let offset = COLUMNS_HEADER_SIZE;
+  const take = (length: number): Int32Array => {
+    const column = new Int32Array(buffer, offset, length);
+    offset += length * 4;
+    return column;
+  };
+
+  const processPid = take(nbProcesses);
+  const processName = take(nbProcesses);
+  const processArrival = take(nbProcesses);
+  const processExecTime = take(nbProcesses);
+  const processPriority = take(nbProcesses);
+  const pid = take(nbSlices);
+  const ts = take(nbSlices);
+  const te = take(nbSlices);
+  const cpu = take(nbSlices);
+  const firstEvent = take(nbSlices + 1);
+  const eventTime = take(nbEvents);
+  const eventComment = take(nbEvents);
+  const stringOffsets = take(nbStrings + 1);
+  if (offset + stringsSize !== buffer.byteLength) {
+    throw new Error('Truncated columnar schedule');
+  }
+
+  const blob = new Uint8Array(buffer, offset, stringsSize);
+  const decoder = new TextDecoder();
+  const strings: string[] = new Array(nbStrings);
+  for (let i = 0; i < nbStrings; i++) {
+    strings[i] = decoder.decode(blob.subarray(stringOffsets[i], stringOffsets[i + 1]));
+  }
+
+  return {
+    algorithm,
+    cpus,
+    processes: {
+      pid: processPid,
+      name: processName,
+      arrival: processArrival,
+      execTime: processExecTime,
+      priority: processPriority,
+    },
+    pid,
+    ts,
+    te,
+    cpu,
+    firstEvent,
+    eventTime,
+    eventComment,
+    strings,
+  };
+}
+
+/** Same request as scheduleProcesses, answered as typed arrays. */
+export async function scheduleProcessesColumns(
+  request: ScheduleRequest
+): Promise<ScheduleColumns> {
+  const controller = new AbortController();
+  const timeoutId = setTimeout(() => controller.abort(), REQUEST_TIMEOUT);
+
+  try {
+    const response = await fetch(`${API_BASE_URL}/schedule`, {
+      method: 'POST',
+      headers: {
+        'Content-Type': 'application/json',
+        Accept: COLUMNS_MIME,
+      },
+      body: JSON.stringify(request),
+      signal: controller.signal,
+    });
+
+    if (!response.ok) {
+      throw new Error(`Server returned ${response.status}: ${await response.text()}`);
+    }
+
+    // Failures are still reported as a JSON error document.
+    if (!(response.headers.get('Content-Type') || '').startsWith(COLUMNS_MIME)) {
+      const data: ScheduleResponse = await response.json();
+      throw new Error(data.error || 'Invalid server response');
+    }
+
+    return parseScheduleColumns(await response.arrayBuffer());
+  } finally {
+    clearTimeout(timeoutId);
+  }
+}
+
+async function getRun<T>(runId: number, view: string, params: Record<string, number | string | undefined>): Promise<T> {
+  const query = new URLSearchParams();
+  for (const [key, value] of Object.entries(params)) {
+    if (value !== undefined) query.set(key, String(value));
+  }
+
+  const controller = new AbortController();
+  const timeoutId = setTimeout(() => controller.abort(), REQUEST_TIMEOUT);
+  try {
+    const response = await fetch(`${API_BASE_URL}/runs/${runId}/${view}?${query}`, {
+      method: 'GET',
+      signal: controller.signal,
+    });
+    if (!response.ok) {
+      throw new Error(`Server returned ${response.status}: ${await response.text()}`);
+    }
+    return await response.json();
+  } finally {
+    clearTimeout(timeoutId);
+  }
+}
+
+/** A window of a finished job's slices; pass the previous page's next as after. */
+export function fetchRunSlices(
+  runId: number,
+  window: { from?: number; to?: number; limit?: number; after?: string } = {}
+): Promise<RunSlicesPage> {
+  return getRun<RunSlicesPage>(runId, 'slices', window);
+}
+
+/** A window of a finished job drawn in at most pixels buckets per CPU. */
+export function fetchRunLod(
+  runId: number,
+  window: { from?: number; to?: number; pixels?: number } = {}
+): Promise<RunLod> {
+  return getRun<RunLod>(runId, 'lod', window);
+}
+
 export async function getServerStatus(): Promise<{
   online: boolean;
   algorithms: AlgorithmInfo[];
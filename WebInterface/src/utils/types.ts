@@ -20,9 +20,113 @@ export interface Execute {
   p: Process;
   ts: number;         
   te: number;   
+  cpu?: number;
   event_count: number;      
   events: CPUEvent[];
 }
+
+export interface CpuTimeline {
+  cpu: number;
+  slices: number;
+  busy: number;
+  end: number;
+}
+/** Times of one process; null when it did not get that far. */
+export interface ProcessMetrics {
+  pid: number;
+  waiting: number | null;
+  turnaround: number | null;
+  response: number | null;
+  preemptions: number;
+}
+
+export interface ScheduleMetrics {
+  completed: number;
+  makespan: number;
+  busy: number;
+  idle: number;
+  utilization: number;
+  throughput: number;
+  waiting: { avg: number; max: number };
+  turnaround: { avg: number; max: number };
+  response: { avg: number; max: number };
+  preemptions: number;
+  fairness: number | null;
+  processes: ProcessMetrics[];
+}
+
+/** A slice of a stored run; its events are the process's from offset on. */
+export interface RunSlice {
+  pid: number;
+  cpu: number;
+  ts: number;
+  te: number;
+  offset: number;
+}
+
+/** One page of GET /api/runs/{id}/slices; next is the after of the following page. */
+export interface RunSlicesPage {
+  id: number;
+  start: number;
+  end: number;
+  from: number;
+  to: number;
+  total: number;
+  slices: RunSlice[];
+  next?: string;
+}
+
+/** A process and how long it ran in a bucket. */
+export interface LodShare {
+  pid: number;
+  busy: number;
+}
+
+/**
+ * What a CPU did over [t, t + bucket): top lists up to four processes that ran
+ * the longest, longest first. It is exact on the finest level only; above it
+ * it is approximate, and a busy is never more than the process really ran.
+ */
+export interface LodBucket {
+  t: number;
+  busy: number;
+  top: LodShare[];
+  slices: number;
+  events: number;
+}
+
+/** GET /api/runs/{id}/lod: at most pixels buckets per CPU; idle buckets are left out. */
+export interface RunLod {
+  id: number;
+  start: number;
+  end: number;
+  from: number;
+  to: number;
+  bucket: number;
+  cpus: { cpu: number; buckets: LodBucket[] }[];
+}
+
+/** Slice i runs process pid[i] on cpu[i] from ts[i] to te[i]; its events are firstEvent[i] .. firstEvent[i + 1] - 1. */
+export interface ScheduleColumns {
+  algorithm: string;
+  cpus: number;
+  processes: {
+    pid: Int32Array;
+    name: Int32Array;
+    arrival: Int32Array;
+    execTime: Int32Array;
+    priority: Int32Array;
+  };
+  pid: Int32Array;
+  ts: Int32Array;
+  te: Int32Array;
+  cpu: Int32Array;
+  firstEvent: Int32Array;
+  eventTime: Int32Array;
+  eventComment: Int32Array;
+  strings: string[];
+}
+
 export interface AlgorithmInfo {
   id: number;
   name: string;  